@@ -1,218 +1,234 @@
-#include <ostream>
-#include <random>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <limits>
-#include <unordered_map>
-#include "Board.hpp"
-#include "Game.hpp"
-
-// Compact board representation for hash table
-struct BoardState {
-    std::vector<uint8_t> board;
-    uint8_t currentPlayer;
-
-    bool operator==(const BoardState& other) const {
-        return board == other.board && currentPlayer == other.currentPlayer;
-    }
-};
-
-// Custom hash function for BoardState
-struct BoardStateHash {
-    std::size_t operator()(const BoardState& state) const {
-        std::size_t hash = 0;
-        for (const auto& cell : state.board) {
-            hash = hash * 31 + cell;
-        }
-        hash = hash * 31 + state.currentPlayer;
-        return hash;
-    }
-};
-
-class Solver {
-private:
-    unsigned long long nodeCount;
-    static constexpr int MAX_DEPTH = 8;
-    static constexpr int WIN_SCORE = 1000000;
-
-    // Transposition table entry
-    struct TTEntry {
+#include <print>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "AI.hpp"
+#include "FixedGame.hpp"
+#include "MCTS.hpp"
+#include "MultiplayerSolver.hpp"
+#include "OpeningBook.hpp"
+#include "Solver.hpp"
+
+namespace {
+    OpeningBook openingBook;
+    MultiplayerEngine multiplayerEngine = MultiplayerEngine::PARANOID;
+
+    // Completed ponder search of one human reply, keyed by the canonical key of the position after it
+    struct PonderedPosition {
+        uint64_t key;
+        uint16_t move;  // In the orientation of the key
         int score;
         int depth;
-        enum class Type { EXACT, LOWER_BOUND, UPPER_BOUND } type;
+        std::chrono::microseconds time;  // Summed over every completed depth
     };
 
-    std::unordered_map<BoardState, TTEntry, BoardStateHash> transpositionTable;
-
-    // Column ordering for better alpha-beta pruning
-    static constexpr std::array<uint16_t, 7> columnOrder = {3, 2, 4, 1, 5, 0, 6};  // Center-first ordering
-
-    // Fast evaluation using bitboards for threat detection
-    int evaluatePosition(const Game& game) const {
-        const auto& board = game.board;
-        int score = 0;
+    // Ponder state is only touched by the thread calling into this module; the background thread
+    // writes results, which are read after it has been joined
+    std::thread ponderThread;
+    std::atomic<bool> ponderActive{false};
+    std::atomic<bool> ponderFinished{false};
+    void (*stopPonderSearch)() = nullptr;
+    std::vector<PonderedPosition> ponderedPositions;
+    uint16_t predictedReply = TranspositionTable::NO_MOVE;  // Second move of the last principal variation
+    int lastSearchDepth = std::numeric_limits<int>::max();  // Depth the last budgeted search completed
+
+    // newGame() of every solver created so far; each registers itself on first use
+    std::vector<void (*)()> newGameHooks;
+
+    template<typename GameType>
+    Solver<GameType>& solverFor() {
+        static Solver<GameType> solver{};  // Keep solver static to reuse transposition table memory
+        [[maybe_unused]] static const bool registered = (newGameHooks.push_back([] { solver.newGame(); }), true);
+        return solver;
+    }
 
-        // Quick center control evaluation
-        const uint16_t centerCol = board.width / 2;
-        const auto& heights = board.heights;
+    // Deepens every human reply one ply per round, the predicted reply first, so whatever the
+    // human plays has been searched about as deep as the others when input arrives
+    template<typename GameType>
+    void ponder(const GameType& root, const uint16_t predicted) {
+        auto& solver = solverFor<GameType>();
 
-        // Value center columns more
-        score += heights[centerCol] * 3;  // Center column
-        if (centerCol > 0) {
-            score += heights[centerCol-1] * 2;  // Adjacent to center
-            score += heights[centerCol+1] * 2;
+        std::vector<uint16_t> replies(root.board.width);
+        centerFirstColumnOrder(replies);
+        if (const auto it = std::ranges::find(replies, predicted); it != replies.end()) {
+            std::rotate(replies.begin(), it, it + 1);
         }
-
-        // Check for immediate threats in each column
-        for (uint16_t col = 0; col < board.width; col++) {
-            const auto height = heights[col];
-            if (height >= board.height) continue;
-
-            // Check if placing here would win
-            const uint16_t row = board.height - 1 - height;
-            const uint16_t pos = row * board.width + col;
-
-            // Horizontal check (most common win condition)
-            if (col <= board.width - 4) {
-                int count = 0;
-                uint8_t lastPlayer = 0;
-                for (uint16_t i = 0; i < 4; i++) {
-                    const auto piece = board.board[pos + i];
-                    if (piece != 0) {
-                        if (lastPlayer == 0) {
-                            lastPlayer = piece;
-                            count = 1;
-                        } else if (piece == lastPlayer) {
-                            count++;
-                        } else {
-                            count = 0;
-                            break;
-                        }
-                    }
-                }
-                if (count == 3) {
-                    score += (lastPlayer == game.currentPlayer ? 100 : -100);
+        // Replies that end the game need no search, and mirrored replies share the entry of their twin
+        const bool symmetric = isMirrorSymmetric(root.board);
+        std::erase_if(replies, [&root, symmetric](const uint16_t col) {
+            GameType child(root);
+            return !child.board.canPlace(col) || child.place(col) || (symmetric && isMirroredColumn(col, root.board.width));
+        });
+
+        const int remaining = root.board.maxMoves - root.board.movesPlayed - 1;
+        for (int depth = 1; depth <= remaining; ++depth) {
+            for (const auto reply : replies) {
+                GameType child(root);
+                (void)child.place(reply);
+                if (!ponderActive.load(std::memory_order_relaxed)) return;
+                const auto result = solver.search(child, {.maxDepth = depth});
+                if (!ponderActive.load(std::memory_order_relaxed)) return;  // Interrupted, result is partial
+
+                const auto key = canonicalKey(child);
+                const auto move = key.orient(result.bestMove, child.board.width);
+                if (const auto it = std::ranges::find(ponderedPositions, key.key, &PonderedPosition::key);
+                    it != ponderedPositions.end()) {
+                    *it = {key.key, move, result.score, depth, it->time + result.time};
+                } else {
+                    ponderedPositions.push_back({key.key, move, result.score, depth, result.time});
                 }
             }
         }
-
-        return score;
     }
 
-    int negamax(const Game& game, int depth, int alpha, int beta) {
-        nodeCount++;
-
-        // Transposition table lookup
-        BoardState state{game.board.board, game.currentPlayer};
-        if (auto it = transpositionTable.find(state); it != transpositionTable.end()) {
-            const auto& entry = it->second;
-            if (entry.depth >= depth) {
-                switch (entry.type) {
-                    case TTEntry::Type::EXACT:
-                        return entry.score;
-                    case TTEntry::Type::LOWER_BOUND:
-                        alpha = std::max(alpha, entry.score);
-                        break;
-                    case TTEntry::Type::UPPER_BOUND:
-                        beta = std::min(beta, entry.score);
-                        break;
-                }
-                if (alpha >= beta) return entry.score;
-            }
-        }
+    template<typename GameType>
+    uint16_t searchMove(const GameType& game, const SearchLimits& limits) {
+        auto& solver = solverFor<GameType>();
 
-        // Check for immediate win using pre-ordered columns
+        // Check for immediate wins using center-first ordering
+        std::vector<uint16_t> columnOrder(game.board.width);
+        centerFirstColumnOrder(columnOrder);
         for (uint16_t col : columnOrder) {
-            if (col >= game.board.width) continue;  // Skip if column index exceeds board width
-            if (game.board.canPlace(col)) {
-                Game testGame(game);
-                if (testGame.place(col)) {
-                    return WIN_SCORE * (depth + 1);
-                }
+            if (game.isWinningMove(col)) {
+                std::println("Found winning move at column {}", col);
+                return col;
             }
         }
 
-        // Base cases
-        if (depth == 0 || game.board.movesPlayed >= game.board.maxMoves) {
-            return evaluatePosition(game);
+        if (const auto entry = openingBook.probe(game); entry && game.board.canPlace(entry->move)) {
+            std::println("Book move: column {} with score {}", entry->move, entry->score);
+            return entry->move;
         }
 
-        int bestScore = -std::numeric_limits<int>::max();
-        TTEntry::Type entryType = TTEntry::Type::UPPER_BOUND;
-
-        // Try each possible move using pre-ordered columns
-        for (uint16_t col : columnOrder) {
-            if (col >= game.board.width) continue;
-            if (game.board.canPlace(col)) {
-                Game gameCopy(game);
-                gameCopy.place(col);
-                const int score = -negamax(gameCopy, depth - 1, -beta, -alpha);
-                if (score > bestScore) {
-                    bestScore = score;
-                    if (score > alpha) {
-                        alpha = score;
-                        entryType = TTEntry::Type::EXACT;
-                        if (alpha >= beta) break;
-                    }
-                }
+        // A reply pondered for the move budget, or as deep as the last search got within it, is played
+        // as is; otherwise the search below starts from the table entries pondering left behind
+        const auto key = canonicalKey(game);
+        if (const auto it = std::ranges::find(ponderedPositions, key.key, &PonderedPosition::key);
+            it != ponderedPositions.end() && it->move != TranspositionTable::NO_MOVE) {
+            const auto move = key.orient(it->move, game.board.width);
+            const int remaining = game.board.maxMoves - game.board.movesPlayed;
+            const int enoughDepth = std::min({limits.maxDepth, remaining, lastSearchDepth});
+            if ((limits.time.count() != 0 && it->time >= limits.time) || it->depth >= enoughDepth) {
+                std::println("Pondered move: column {} with score {} at depth {}", move, it->score, it->depth);
+                predictedReply = TranspositionTable::NO_MOVE;
+                lastSearchDepth = it->depth;  // Later positions need at least as deep a ponder
+                return move;
             }
         }
 
-        // Store position in transposition table
-        transpositionTable[state] = {bestScore, depth, entryType};
-        return bestScore;
-    }
+        const auto result = solver.search(game, limits);
+        predictedReply = result.pv.size() > 1 ? result.pv[1] : TranspositionTable::NO_MOVE;
+        lastSearchDepth = result.depth;
 
-public:
-    Solver() {
-        // Reserve space for transposition table
-        transpositionTable.reserve(1000000);
-    }
+        std::println("Choosing column {} with score {} at depth {}", result.bestMove, result.score, result.depth);
+        std::println("Principal variation: {}", result.pv);
+        std::println("Nodes evaluated: {} in {} ms", result.nodes, result.time.count() / 1000.0);
 
-    int solve(const Game& game, int depth = MAX_DEPTH) {
-        nodeCount = 0;
-        transpositionTable.clear();  // Clear table for new search
-        return negamax(Game(game), depth, -std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
+        return result.bestMove;
     }
 
-    [[nodiscard]] unsigned long long getNodeCount() const {
-        return nodeCount;
+    uint16_t monteCarloMove(const Game& game, const SearchLimits& limits) {
+        static MCTS<Game> mcts{};  // Keep the engine static to reuse its node arenas
+
+        const auto result = mcts.search(game, limits);
+
+        std::println("Choosing column {} after {} playouts ({:.0f}/s)", result.bestMove, result.playouts,
+                     result.playoutsPerSecond());
+        std::println("Visits per column: {}", result.visits);
+        std::println("Expected rewards per player: {::.3f}", result.rewards);
+
+        return result.bestMove;
     }
-};
 
-uint16_t getMove(Game& game) {
-    static Solver solver{};  // Keep solver static to reuse transposition table memory
-    std::vector<std::pair<int, uint16_t>> moveScores;
-    moveScores.reserve(game.board.width);
-
-    // Check for immediate wins using center-first ordering
-    for (uint16_t col : {3, 2, 4, 1, 5, 0, 6}) {
-        if (col >= game.board.width) continue;
-        if (game.board.canPlace(col)) {
-            Game testGame(game);
-            if (testGame.place(col)) {
-                std::println("Found winning move at column {}", col);
-                return col;
-            }
+    // Negamax assumes the next player is the only opponent, so games with more players use a
+    // multi-player search instead
+    uint16_t multiplayerMove(const Game& game, const SearchLimits& limits) {
+        if (multiplayerEngine == MultiplayerEngine::MCTS) {
+            return monteCarloMove(game, limits);
         }
+
+        static MultiplayerSolver<Game> solver{};  // Keep solver static to reuse transposition table memory
+        [[maybe_unused]] static const bool registered = (newGameHooks.push_back([] { solver.newGame(); }), true);
+        solver.setStrategy(multiplayerEngine == MultiplayerEngine::MAXN ? MultiplayerStrategy::MAXN
+                                                                        : MultiplayerStrategy::PARANOID);
+        const auto result = solver.search(game, limits);
+
+        std::println("Choosing column {} with score {} at depth {}", result.bestMove, result.score, result.depth);
+        std::println("Principal variation: {}", result.pv);
+        std::println("Nodes evaluated: {} in {} ms", result.nodes, result.time.count() / 1000.0);
+
+        return result.bestMove;
     }
+}
 
-    // Evaluate moves in parallel for better performance
-    #pragma omp parallel for if(game.board.movesPlayed < 10)
-    for (uint16_t col = 0; col < game.board.width; col++) {
-        if (game.board.canPlace(col)) {
-            Game gameCopy(game);
-            gameCopy.place(col);
-            int score = -solver.solve(gameCopy);
-            #pragma omp critical
-            moveScores.emplace_back(score, col);
-            std::println("Column {} score: {}", col, score);
-        }
+uint16_t getMove(Game& game, const SearchLimits& limits) {
+    stopPondering();  // The solver is not shared with the background search
+
+    if (game.numberOfPlayers > 2) {
+        return multiplayerMove(game, limits);
     }
 
-    auto bestMove = std::max_element(moveScores.begin(), moveScores.end());
-    uint16_t bestCol = bestMove->second;
+    // Common sizes are searched on a compile-time specialized board, others on a copy of game
+    return visitFixedGame(game, [&limits](const auto& searchGame) {
+        return searchMove(searchGame, limits);
+    });
+}
 
-    std::println("Choosing column {} with score {}", bestCol, bestMove->first);
-    std::println("Nodes evaluated: {}", solver.getNodeCount());
+uint16_t getMove(Game& game) {
+    return getMove(game, {.time = DEFAULT_MOVE_TIME});
+}
+
+void newGame() {
+    stopPondering();
+    ponderedPositions.clear();
+    predictedReply = TranspositionTable::NO_MOVE;
+    lastSearchDepth = std::numeric_limits<int>::max();
+    for (const auto hook : newGameHooks) hook();
+}
+
+void setMultiplayerEngine(const MultiplayerEngine engine) {
+    multiplayerEngine = engine;
+}
+
+std::expected<void, std::string> loadOpeningBook(const std::string& path) {
+    return openingBook.open(path);
+}
+
+void startPondering(const Game& game) {
+    stopPondering();
+    ponderedPositions.clear();
+    if (game.numberOfPlayers > 2 || game.board.movesPlayed + 1 >= game.board.maxMoves) {
+        return;
+    }
 
-    return bestCol;
-}
\ No newline at end of file
+    ponderActive.store(true, std::memory_order_relaxed);
+    ponderFinished.store(false, std::memory_order_relaxed);
+    visitFixedGame(game, [](const auto& ponderGame) {
+        using GameType = std::remove_cvref_t<decltype(ponderGame)>;
+        stopPonderSearch = [] { solverFor<GameType>().stop(); };
+        ponderThread = std::thread([root = ponderGame, predicted = predictedReply] {
+            ponder(root, predicted);
+            ponderFinished.store(true, std::memory_order_release);
+        });
+    });
+}
+
+void stopPondering() {
+    if (!ponderThread.joinable()) {
+        return;
+    }
+
+    // search() clears the stop flag when it starts, so a stop landing just before the next reply's
+    // search would be lost; keep stopping until the thread has seen ponderActive drop
+    ponderActive.store(false, std::memory_order_relaxed);
+    while (!ponderFinished.load(std::memory_order_acquire)) {
+        stopPonderSearch();
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    ponderThread.join();
+}
@@ -1,18 +1,33 @@
 #pragma once
+#include <chrono>
 #include <cstdint>
+#include <expected>
+#include <string>
 
 #include "Board.hpp"
 #include "Game.hpp"
+#include "Solver.hpp"
 
-class Solver {
-private:
-    unsigned long long nodeCount;
+// Think time per move when no explicit limits are given
+inline constexpr std::chrono::milliseconds DEFAULT_MOVE_TIME{1000};
 
-    int negamax(Game& game);
+// Returns the best move found within the limits (iterative deepening stops when the budget is spent)
+uint16_t getMove(Game& game, const SearchLimits& limits);
+uint16_t getMove(Game& game);
 
-public:
-    int solve(const Game& game);
-    [[nodiscard]] unsigned long long getNodeCount() const;
-};
+// Searches every reply to game (the predicted one first) on a background thread while the opponent
+// thinks. getMove() stops it and plays the pondered move outright when the reply that was played got
+// at least the move budget, otherwise it searches on from the warm transposition table. Two-player
+// games only; call stopPondering() before exiting if the game ended during pondering.
+void startPondering(const Game& game);
+void stopPondering();
 
-uint16_t getMove(Game& game);
\ No newline at end of file
+// Search results persist across moves and games; this drops them and the pondering state
+void newGame();
+
+// Engine used when a game has more than two players
+enum class MultiplayerEngine { PARANOID, MAXN, MCTS };
+void setMultiplayerEngine(MultiplayerEngine engine);
+
+// Memory-maps an opening book generated by ConnectFourBook; getMove() plays from it while in book
+std::expected<void, std::string> loadOpeningBook(const std::string& path);
@@ -0,0 +1,347 @@
+// Offline bulk analysis: streams a file of positions, one move list per line (space separated columns,
+// or one digit string such as 3342 when the width is at most 10, empty for the start position), through
+// worker threads that each own a Solver, and writes one result per line in input order.
+//
+// The input is memory-mapped and cut into chunks of lines; at most a few chunks per worker are in flight
+// between the reader and the in-order writer, so memory stays bounded however large the input is, and
+// pages of the input that were written out are dropped as the pipeline moves on. Workers keep their
+// transposition tables between positions, so a result can reflect deeper entries left by an earlier line.
+//
+// CSV output: line,status,bestmove,score,depth,nodes,time_us with status ok, invalid or over.
+// Binary output: one 24-byte AnalysisRecord per line in native byte order.
+//
+// Usage: ConnectFourAnalyze <input> <output> [--format csv|binary] [--width W] [--height H]
+//                           [--depth D] [--movetime MS] [--nodes N] [--hash MB] [--threads T]
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <expected>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <print>
+#include <semaphore>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "FixedGame.hpp"
+#include "Solver.hpp"
+#include "ThreadPool.hpp"
+
+namespace {
+    constexpr std::size_t LINES_PER_CHUNK = 256;
+    constexpr unsigned CHUNKS_PER_THREAD = 4;  // In flight between the reader and the writer
+
+    enum class Status : uint8_t { OK, INVALID, OVER };
+
+    struct AnalysisRecord {
+        uint64_t nodes;
+        int32_t score;
+        uint32_t timeMicros;
+        uint16_t bestMove;  // NO_MOVE unless status is OK
+        uint8_t depth;
+        Status status;
+        uint32_t reserved;
+    };
+    static_assert(sizeof(AnalysisRecord) == 24);
+
+    struct Options {
+        std::string input;
+        std::string output;
+        bool binary{false};
+        uint16_t width{7};
+        uint16_t height{6};
+        SearchLimits limits{.maxDepth = 12};
+        std::size_t hashMB{16};
+        unsigned threads{std::max(1u, std::thread::hardware_concurrency())};
+    };
+
+    struct Chunk {
+        std::size_t index;
+        std::size_t firstLine;
+        std::size_t endOffset;  // Input bytes up to here are done once the chunk is written
+        std::vector<std::string_view> lines;
+        std::string output;
+    };
+
+    // Unbounded by itself; the reader's in-flight semaphore is what limits its size
+    class ChunkQueue {
+    public:
+        void push(std::unique_ptr<Chunk> chunk) {
+            {
+                const std::scoped_lock lock(mutex);
+                chunks.push_back(std::move(chunk));
+            }
+            available.notify_one();
+        }
+
+        void close() {
+            {
+                const std::scoped_lock lock(mutex);
+                closed = true;
+            }
+            available.notify_all();
+        }
+
+        // Null once the queue is closed and drained
+        std::unique_ptr<Chunk> pop() {
+            std::unique_lock lock(mutex);
+            available.wait(lock, [this] { return closed || !chunks.empty(); });
+            if (chunks.empty()) return nullptr;
+            auto chunk = std::move(chunks.front());
+            chunks.pop_front();
+            return chunk;
+        }
+
+    private:
+        std::mutex mutex;
+        std::condition_variable available;
+        std::deque<std::unique_ptr<Chunk>> chunks;
+        bool closed{false};
+    };
+
+    class MappedInput {
+    public:
+        ~MappedInput() {
+            if (data) ::munmap(data, size);
+        }
+
+        std::expected<void, std::string> open(const std::string& path) {
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                return std::unexpected("Cannot open " + path);
+            }
+            struct stat info{};
+            if (::fstat(fd, &info) != 0) {
+                ::close(fd);
+                return std::unexpected("Cannot read " + path);
+            }
+            size = static_cast<std::size_t>(info.st_size);
+            if (size == 0) {
+                ::close(fd);
+                return {};
+            }
+            void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (mapping == MAP_FAILED) {
+                return std::unexpected("Failed to map " + path);
+            }
+            data = static_cast<char*>(mapping);
+            ::madvise(data, size, MADV_SEQUENTIAL);
+            return {};
+        }
+
+        [[nodiscard]] std::string_view text() const noexcept {
+            return {data, size};
+        }
+
+        // Drops the resident pages below offset; they are read again from the file if ever touched
+        void release(const std::size_t offset) noexcept {
+            const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+            const auto end = offset / page * page;
+            if (end > released) {
+                ::madvise(data + released, end - released, MADV_DONTNEED);
+                released = end;
+            }
+        }
+
+    private:
+        char* data{nullptr};
+        std::size_t size{0};
+        std::size_t released{0};
+    };
+
+    template<typename GameType>
+    [[nodiscard]] Status playLine(GameType& game, const std::string_view line) {
+        const auto play = [&game](const uint16_t col) {
+            if (col >= game.board.width || !game.board.canPlace(col)) return Status::INVALID;
+            return game.place(col) ? Status::OVER : Status::OK;
+        };
+
+        const bool digitString = game.board.width <= 10 && line.find_first_of(" \t,") == std::string_view::npos;
+        Status status = Status::OK;
+        std::size_t pos = 0;
+        while (pos < line.size()) {
+            if (line[pos] == ' ' || line[pos] == '\t' || line[pos] == ',' || line[pos] == '\r') {
+                ++pos;
+                continue;
+            }
+            if (line[pos] < '0' || line[pos] > '9' || status != Status::OK) return Status::INVALID;
+            uint16_t col = 0;
+            if (digitString) {
+                col = static_cast<uint16_t>(line[pos++] - '0');
+            } else {
+                for (; pos < line.size() && line[pos] >= '0' && line[pos] <= '9'; ++pos) {
+                    col = static_cast<uint16_t>(std::min(col * 10 + (line[pos] - '0'), 0xFFFF));
+                }
+            }
+            status = play(col);
+            if (status == Status::INVALID) return status;
+        }
+        return status;
+    }
+
+    template<typename GameType>
+    void analyzeChunk(Chunk& chunk, Solver<GameType>& solver, const GameType& empty, const Options& options) {
+        for (std::size_t i = 0; i < chunk.lines.size(); ++i) {
+            GameType game(empty);
+            AnalysisRecord record{0, 0, 0, TranspositionTable::NO_MOVE, 0, playLine(game, chunk.lines[i]), 0};
+            if (record.status == Status::OK && game.board.movesPlayed >= game.board.maxMoves) {
+                record.status = Status::OVER;
+            }
+            if (record.status == Status::OK) {
+                const auto result = solver.search(game, options.limits);
+                record = {result.nodes, result.score, static_cast<uint32_t>(result.time.count()), result.bestMove,
+                          static_cast<uint8_t>(std::min(result.depth, 255)), Status::OK, 0};
+            }
+
+            if (options.binary) {
+                chunk.output.append(reinterpret_cast<const char*>(&record), sizeof(record));
+            } else if (record.status == Status::OK) {
+                std::format_to(std::back_inserter(chunk.output), "{},ok,{},{},{},{},{}\n", chunk.firstLine + i,
+                               record.bestMove, record.score, record.depth, record.nodes, record.timeMicros);
+            } else {
+                std::format_to(std::back_inserter(chunk.output), "{},{},,,,,\n", chunk.firstLine + i,
+                               record.status == Status::OVER ? "over" : "invalid");
+            }
+        }
+    }
+
+    template<typename GameType>
+    int analyze(const GameType& empty, const Options& options) {
+        MappedInput input;
+        if (const auto opened = input.open(options.input); !opened) {
+            std::println("{}", opened.error());
+            return 1;
+        }
+        std::ofstream out(options.output, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::println("Cannot create {}", options.output);
+            return 1;
+        }
+        if (!options.binary) {
+            out << "line,status,bestmove,score,depth,nodes,time_us\n";
+        }
+
+        ChunkQueue queue;
+        std::counting_semaphore<> inFlight(options.threads * CHUNKS_PER_THREAD);
+
+        // Chunks finish out of order; whichever worker completes the next one in line writes it and
+        // everything queued behind it
+        std::mutex writeMutex;
+        std::map<std::size_t, std::unique_ptr<Chunk>> finished;
+        std::size_t nextToWrite = 0;
+        const auto commit = [&](std::unique_ptr<Chunk> chunk) {
+            const std::scoped_lock lock(writeMutex);
+            finished.emplace(chunk->index, std::move(chunk));
+            while (!finished.empty() && finished.begin()->first == nextToWrite) {
+                const auto& ready = *finished.begin()->second;
+                out.write(ready.output.data(), static_cast<std::streamsize>(ready.output.size()));
+                input.release(ready.endOffset);
+                finished.erase(finished.begin());
+                ++nextToWrite;
+                inFlight.release();
+            }
+        };
+
+        const auto worker = [&] {
+            Solver<GameType> solver(options.hashMB, 1);  // Workers only share the queue and the writer
+            while (auto chunk = queue.pop()) {
+                analyzeChunk(*chunk, solver, empty, options);
+                commit(std::move(chunk));
+            }
+        };
+
+        const auto start = std::chrono::steady_clock::now();
+        ThreadPool::global().ensureWorkers(options.threads);
+        TaskGroup workers;
+        for (unsigned i = 0; i < options.threads; ++i) {
+            workers.run(worker);
+        }
+
+        // The calling thread reads, blocking whenever the workers or the writer fall behind
+        const auto text = input.text();
+        std::size_t offset = 0;
+        std::size_t lineCount = 0;
+        for (std::size_t index = 0; offset < text.size(); ++index) {
+            inFlight.acquire();
+            auto chunk = std::make_unique<Chunk>(Chunk{index, lineCount, 0, {}, {}});
+            chunk->lines.reserve(LINES_PER_CHUNK);
+            while (offset < text.size() && chunk->lines.size() < LINES_PER_CHUNK) {
+                const auto end = std::min(text.find('\n', offset), text.size());
+                chunk->lines.push_back(text.substr(offset, end - offset));
+                offset = end + 1;
+            }
+            chunk->endOffset = std::min(offset, text.size());
+            lineCount += chunk->lines.size();
+            queue.push(std::move(chunk));
+        }
+        queue.close();
+        workers.wait();
+
+        if (!out.flush()) {
+            std::println("Failed to write {}", options.output);
+            return 1;
+        }
+        const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+        std::println("Analyzed {} positions in {:.2f} seconds ({:.0f}/s) on {} threads", lineCount, duration.count(),
+                     static_cast<double>(lineCount) / std::max(duration.count(), 1e-9), options.threads);
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            const auto text = [&]() -> std::string {
+                if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + arg);
+                return argv[++i];
+            };
+            const auto value = [&] { return std::stoll(text()); };
+            if (arg == "--format") {
+                const auto format = text();
+                if (format != "csv" && format != "binary") throw std::invalid_argument("Unknown format " + format);
+                options.binary = format == "binary";
+            }
+            else if (arg == "--width") options.width = static_cast<uint16_t>(value());
+            else if (arg == "--height") options.height = static_cast<uint16_t>(value());
+            else if (arg == "--depth") options.limits.maxDepth = static_cast<int>(std::max(1LL, value()));
+            else if (arg == "--movetime") options.limits.time = std::chrono::milliseconds(std::max(0LL, value()));
+            else if (arg == "--nodes") options.limits.nodes = static_cast<unsigned long long>(std::max(0LL, value()));
+            else if (arg == "--hash") options.hashMB = static_cast<std::size_t>(std::max(1LL, value()));
+            else if (arg == "--threads") options.threads = static_cast<unsigned>(std::clamp(value(), 1LL, 255LL));
+            else if (options.input.empty()) options.input = arg;
+            else if (options.output.empty()) options.output = arg;
+            else throw std::invalid_argument("Unknown argument " + arg);
+        }
+        if (options.output.empty()) {
+            throw std::invalid_argument("Missing input or output path");
+        }
+
+        const Game game(options.width, options.height, 2);
+        return visitFixedGame(game, [&options](const auto& empty) {
+            return analyze(empty, options);
+        });
+    } catch (const std::exception& e) {
+        std::println("{}", e.what());
+        std::println("Usage: ConnectFourAnalyze <input> <output> [--format csv|binary] [--width W] [--height H] "
+                     "[--depth D] [--movetime MS] [--nodes N] [--hash MB] [--threads T]");
+        return 1;
+    }
+}
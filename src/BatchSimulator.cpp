@@ -0,0 +1,207 @@
+#include "BatchSimulator.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <type_traits>
+
+#include "Zobrist.hpp"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define BATCH_SIMULATOR_X86 1
+#endif
+
+namespace {
+    using BoardType = BatchSimulator::GameType::BoardType;
+    using Mask = BatchSimulator::Mask;
+
+    constexpr int H1 = BoardType::height + 1;
+    constexpr Mask COLUMN = (Mask{1} << BoardType::height) - 1;
+    constexpr Mask FULL_FLAGS = BatchSimulator::GAME_OVER;
+    constexpr Mask WIN_FLAGS = BatchSimulator::GAME_OVER | BatchSimulator::LAST_MOVE_WON;
+
+    static_assert(std::is_same_v<Mask, uint64_t>, "Lanes are 64-bit");
+    static_assert((BoardType::boardMask & WIN_FLAGS) == 0, "Flags must not overlap the board");
+
+    using Kernel = void (*)(Mask*, Mask*, const uint8_t*, std::size_t) noexcept;
+
+    // Same steps as the vector kernels, one game at a time
+    void playScalar(Mask* current, Mask* mask, const uint8_t* columns, const std::size_t count) noexcept {
+        for (std::size_t i = 0; i < count; ++i) {
+            if (mask[i] & BatchSimulator::GAME_OVER || columns[i] >= BoardType::width) continue;
+            const Mask move = (mask[i] + BoardType::bottomMask) & (COLUMN << (columns[i] * H1));
+            if (!move) continue;
+
+            current[i] ^= mask[i];
+            mask[i] |= move;
+            if (BoardType::hasLine(current[i] ^ mask[i])) {
+                mask[i] |= WIN_FLAGS;
+            } else if ((mask[i] & BoardType::boardMask) == BoardType::boardMask) {
+                mask[i] |= FULL_FLAGS;
+            }
+        }
+    }
+
+#ifdef BATCH_SIMULATOR_X86
+    template<int Shift>
+    __attribute__((target("avx2"))) __m256i lines256(const __m256i stones) noexcept {
+        const __m256i pairs = _mm256_and_si256(stones, _mm256_srli_epi64(stones, Shift));
+        return _mm256_and_si256(pairs, _mm256_srli_epi64(pairs, 2 * Shift));
+    }
+
+    __attribute__((target("avx2")))
+    void playAvx2(Mask* current, Mask* mask, const uint8_t* columns, const std::size_t count) noexcept {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i bottom = _mm256_set1_epi64x(static_cast<long long>(BoardType::bottomMask));
+        const __m256i board = _mm256_set1_epi64x(static_cast<long long>(BoardType::boardMask));
+        const __m256i column = _mm256_set1_epi64x(static_cast<long long>(COLUMN));
+        const __m256i gameOver = _mm256_set1_epi64x(static_cast<long long>(BatchSimulator::GAME_OVER));
+        const __m256i winFlags = _mm256_set1_epi64x(static_cast<long long>(WIN_FLAGS));
+
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m256i cur = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(current + i));
+            __m256i msk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask + i));
+            int packed;
+            std::memcpy(&packed, columns + i, sizeof(packed));
+            const __m256i col = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(packed));
+
+            // Shifts of 64 or more yield 0 and shifts past the board hit no free cell, so bad columns are rejected
+            const __m256i shift = _mm256_sub_epi64(_mm256_slli_epi64(col, 3), col);
+            __m256i move = _mm256_and_si256(_mm256_add_epi64(msk, bottom), _mm256_sllv_epi64(column, shift));
+            const __m256i active = _mm256_cmpeq_epi64(_mm256_and_si256(msk, gameOver), zero);
+            const __m256i legal = _mm256_andnot_si256(_mm256_cmpeq_epi64(move, zero), active);
+            move = _mm256_and_si256(move, legal);
+
+            cur = _mm256_blendv_epi8(cur, _mm256_xor_si256(cur, msk), legal);
+            msk = _mm256_or_si256(msk, move);
+
+            const __m256i stones = _mm256_xor_si256(cur, msk);
+            const __m256i lines = _mm256_or_si256(
+                _mm256_or_si256(lines256<1>(stones), lines256<H1>(stones)),
+                _mm256_or_si256(lines256<H1 - 1>(stones), lines256<H1 + 1>(stones)));
+            const __m256i won = _mm256_andnot_si256(_mm256_cmpeq_epi64(lines, zero), legal);
+            const __m256i full = _mm256_and_si256(_mm256_cmpeq_epi64(_mm256_and_si256(msk, board), board), legal);
+            msk = _mm256_or_si256(msk, _mm256_or_si256(_mm256_and_si256(won, winFlags), _mm256_and_si256(full, gameOver)));
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(current + i), cur);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(mask + i), msk);
+        }
+        playScalar(current + i, mask + i, columns + i, count - i);
+    }
+
+    template<int Shift>
+    __attribute__((target("avx512f"))) __m512i lines512(const __m512i stones) noexcept {
+        const __m512i pairs = _mm512_and_si512(stones, _mm512_srli_epi64(stones, Shift));
+        return _mm512_and_si512(pairs, _mm512_srli_epi64(pairs, 2 * Shift));
+    }
+
+    __attribute__((target("avx512f")))
+    void playAvx512(Mask* current, Mask* mask, const uint8_t* columns, const std::size_t count) noexcept {
+        const __m512i bottom = _mm512_set1_epi64(static_cast<long long>(BoardType::bottomMask));
+        const __m512i board = _mm512_set1_epi64(static_cast<long long>(BoardType::boardMask));
+        const __m512i column = _mm512_set1_epi64(static_cast<long long>(COLUMN));
+        const __m512i gameOver = _mm512_set1_epi64(static_cast<long long>(BatchSimulator::GAME_OVER));
+        const __m512i winFlags = _mm512_set1_epi64(static_cast<long long>(WIN_FLAGS));
+
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m512i cur = _mm512_loadu_si512(current + i);
+            __m512i msk = _mm512_loadu_si512(mask + i);
+            const __m512i col = _mm512_cvtepu8_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(columns + i)));
+
+            const __m512i shift = _mm512_sub_epi64(_mm512_slli_epi64(col, 3), col);
+            const __m512i move = _mm512_and_si512(_mm512_add_epi64(msk, bottom), _mm512_sllv_epi64(column, shift));
+            const __mmask8 legal = _mm512_test_epi64_mask(move, move) & _mm512_testn_epi64_mask(msk, gameOver);
+
+            cur = _mm512_mask_xor_epi64(cur, legal, cur, msk);
+            msk = _mm512_mask_or_epi64(msk, legal, msk, move);
+
+            const __m512i stones = _mm512_xor_si512(cur, msk);
+            const __m512i lines = _mm512_or_si512(
+                _mm512_or_si512(lines512<1>(stones), lines512<H1>(stones)),
+                _mm512_or_si512(lines512<H1 - 1>(stones), lines512<H1 + 1>(stones)));
+            const __mmask8 won = _mm512_mask_test_epi64_mask(legal, lines, lines);
+            const __mmask8 full = _mm512_mask_cmpeq_epi64_mask(legal & ~won, _mm512_and_si512(msk, board), board);
+            msk = _mm512_mask_or_epi64(msk, won, msk, winFlags);
+            msk = _mm512_mask_or_epi64(msk, full, msk, gameOver);
+
+            _mm512_storeu_si512(current + i, cur);
+            _mm512_storeu_si512(mask + i, msk);
+        }
+        playScalar(current + i, mask + i, columns + i, count - i);
+    }
+#endif
+
+    struct Backend {
+        Kernel kernel;
+        const char* name;
+    };
+
+    const Backend& selectBackend() noexcept {
+        static const Backend backend = []() -> Backend {
+#ifdef BATCH_SIMULATOR_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) return {playAvx512, "AVX-512"};
+            if (__builtin_cpu_supports("avx2")) return {playAvx2, "AVX2"};
+#endif
+            return {playScalar, "scalar"};
+        }();
+        return backend;
+    }
+}
+
+BatchSimulator::BatchSimulator(const std::size_t games)
+    : current(games, 0)
+    , mask(games, 0)
+    , columns(games, 0)
+{}
+
+void BatchSimulator::reset() noexcept {
+    std::ranges::fill(current, 0);
+    std::ranges::fill(mask, 0);
+}
+
+void BatchSimulator::load(const std::size_t index, const GameType& game) noexcept {
+    const auto& masks = game.board.bitboardMasks();
+    current[index] = masks[game.currentPlayer - 1];
+    mask[index] = masks[0] | masks[1];
+}
+
+void BatchSimulator::play(const std::span<const uint8_t> moves) noexcept {
+    selectBackend().kernel(current.data(), mask.data(), moves.data(), std::min(moves.size(), size()));
+}
+
+void BatchSimulator::playRandom(uint64_t seed) {
+    seed = zobrist::mix(seed) | 1;  // xorshift must not start from 0
+    while (finishedGames() < size()) {
+        // Each xorshift64* output feeds 8 games, one byte each, scaled to a column without division
+        for (std::size_t i = 0; i < columns.size(); i += 8) {
+            seed ^= seed >> 12;
+            seed ^= seed << 25;
+            seed ^= seed >> 27;
+            const uint64_t random = seed * 0x2545F4914F6CDD1DULL;
+            for (std::size_t j = 0; j < 8 && i + j < columns.size(); ++j) {
+                columns[i + j] = static_cast<uint8_t>((random >> (8 * j) & 0xFF) * BoardType::width >> 8);
+            }
+        }
+        play(columns);
+    }
+}
+
+uint8_t BatchSimulator::winner(const std::size_t index) const noexcept {
+    if (!(mask[index] & LAST_MOVE_WON)) return 0;
+    return movesPlayed(index) % 2 == 1 ? 1 : 2;  // Player 1 plays the odd moves
+}
+
+uint16_t BatchSimulator::movesPlayed(const std::size_t index) const noexcept {
+    return static_cast<uint16_t>(std::popcount(mask[index] & BoardType::boardMask));
+}
+
+std::size_t BatchSimulator::finishedGames() const noexcept {
+    return static_cast<std::size_t>(std::ranges::count_if(mask, [](const Mask m) { return (m & GAME_OVER) != 0; }));
+}
+
+const char* BatchSimulator::backend() noexcept {
+    return selectBackend().name;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "FixedGame.hpp"
+
+// Runs thousands of independent 7x6 two-player games side by side in structure-of-arrays form.
+// Every game is two bitboard lanes: the stones of the side to move and all stones, with the
+// game-over flags stored in spare high bits. Moves and win checks are applied to 8 games per
+// instruction with AVX-512 or 4 with AVX2 (picked at runtime), with a scalar fallback.
+class BatchSimulator {
+public:
+    using GameType = FixedGame<7, 6>;
+    using Mask = GameType::BoardType::Mask;
+
+    explicit BatchSimulator(std::size_t games);
+
+    // Restarts every game from the empty board
+    void reset() noexcept;
+
+    // Replaces game index with an undecided position
+    void load(std::size_t index, const GameType& game) noexcept;
+
+    // Drops columns[i] into game i; finished games, full columns and out of range columns are left untouched
+    void play(std::span<const uint8_t> columns) noexcept;
+
+    // Plays uniformly random columns in every game until all of them are over
+    void playRandom(uint64_t seed);
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return current.size();
+    }
+
+    [[nodiscard]] bool isOver(const std::size_t index) const noexcept {
+        return (mask[index] & GAME_OVER) != 0;
+    }
+
+    // Winning player (1 or 2), or 0 for a draw or an unfinished game
+    [[nodiscard]] uint8_t winner(std::size_t index) const noexcept;
+
+    [[nodiscard]] uint16_t movesPlayed(std::size_t index) const noexcept;
+
+    [[nodiscard]] std::size_t finishedGames() const noexcept;
+
+    // Name of the instruction set play() runs on
+    [[nodiscard]] static const char* backend() noexcept;
+
+    // Set on a game's mask once it is over, plus LAST_MOVE_WON when the last stone connected four
+    static constexpr Mask GAME_OVER = Mask{1} << 63;
+    static constexpr Mask LAST_MOVE_WON = Mask{1} << 62;
+
+private:
+    std::vector<Mask> current;  // Stones of the side to move
+    std::vector<Mask> mask;     // All stones plus the game-over flags
+    std::vector<uint8_t> columns;
+};
@@ -1,55 +1,562 @@
-#include <atomic>
-#include <exception>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <functional>
+#include <numeric>
+#include <print>
+#include <stdexcept>
+#include <string_view>
 #include <thread>
+#include <tuple>
+#include <vector>
 
+#include "Benchmark.hpp"
+#include "BatchSimulator.hpp"
+#include "ExactSolver.hpp"
+#include "FixedGame.hpp"
 #include "Game.hpp"
+#include "MCTS.hpp"
+#include "MultiplayerSolver.hpp"
+#include "Solver.hpp"
+#include "ThreadPool.hpp"
 
-void runGameBatch(const int numGames, const std::vector<int>& moves, std::atomic<int>& errorCount) {
-    for (int i = 0; i < numGames; ++i) {
-        try {
-            Game game(7, 6, 2);
-            for (const int move : moves) {
-                auto _ = game.place(move);
+namespace {
+    using Clock = std::chrono::steady_clock;
+    using StandardGame = FixedGame<7, 6>;
+
+    // Games simulated side by side; small enough for the lanes to stay in L2
+    constexpr std::size_t BATCH_SIZE = 4096;
+
+    // Positions on the 7x6 board as the columns played from the empty board
+    struct BenchmarkPosition {
+        std::string_view name;
+        std::string_view moves;
+    };
+
+    constexpr std::array SEARCH_POSITIONS = {
+        BenchmarkPosition{"empty", ""},
+        BenchmarkPosition{"opening", "3342"},
+        BenchmarkPosition{"midgame", "42043323"},
+        BenchmarkPosition{"late", "420433233156"},
+    };
+
+    // Exact solves between a few tens of milliseconds and about a second
+    constexpr std::array EXACT_POSITIONS = {
+        BenchmarkPosition{"8ply", "31565261"},
+        BenchmarkPosition{"10ply", "2444065061"},
+        BenchmarkPosition{"12ply", "420433233156"},
+    };
+
+    // Positions on the 7x6 board with the columns that keep the exact outcome (win or draw) of the side to
+    // move, from ExactSolver::analyze on random games; at least three other columns lose ground
+    struct StrengthPosition {
+        std::string_view moves;
+        std::string_view bestColumns;
+    };
+
+    constexpr std::array STRENGTH_POSITIONS = {
+        StrengthPosition{"12264536111256", "6"},
+        StrengthPosition{"10361403553146", "35"},
+        StrengthPosition{"1154605126466513", "2"},
+        StrengthPosition{"54051351223665", "3"},
+        StrengthPosition{"531161221625112400", "3"},
+        StrengthPosition{"100131351115036", "4"},
+        StrengthPosition{"0016160043203524504", "3"},
+        StrengthPosition{"214206141440466", "2"},
+        StrengthPosition{"1261203122641113", "36"},
+        StrengthPosition{"430002640535424", "25"},
+        StrengthPosition{"52163110511423", "2"},
+        StrengthPosition{"5061160004061566612", "2"},
+        StrengthPosition{"33653553423030", "246"},
+        StrengthPosition{"244400425644200651", "156"},
+        StrengthPosition{"004453044664", "3"},
+        StrengthPosition{"230160355125620", "1256"},
+        StrengthPosition{"5202402316523326", "35"},
+        StrengthPosition{"1225224644213", "3"},
+        StrengthPosition{"24435114434654133136", "6"},
+        StrengthPosition{"6444266233325", "2"},
+        StrengthPosition{"235644406106320", "02"},
+        StrengthPosition{"606235033150550104", "26"},
+        StrengthPosition{"34510626055004312", "1"},
+        StrengthPosition{"306520322143360050", "26"},
+        StrengthPosition{"551612462025041", "1"},
+        StrengthPosition{"131145122234", "34"},
+        StrengthPosition{"66025325200640655", "3"},
+        StrengthPosition{"15564335564156", "6"},
+        StrengthPosition{"311446660161", "3"},
+        StrengthPosition{"22460113164461", "2"},
+        StrengthPosition{"4661010300114", "0"},
+        StrengthPosition{"126654324530", "23"},
+    };
+
+    // Position used by the thread scaling benchmarks
+    constexpr std::string_view MIDGAME_POSITION = "42043323";
+
+    // Sink for results the optimizer must not discard
+    volatile uint64_t sink = 0;
+
+    template<typename GameType>
+    void playMoves(GameType& game, const std::string_view moves) {
+        for (const char move : moves) {
+            const auto col = static_cast<uint16_t>(move - '0');
+            if (col >= game.board.width || !game.board.canPlace(col) || game.place(col)) {
+                throw std::invalid_argument(std::format("Benchmark position {} is not an undecided position", moves));
             }
-        } catch (const std::exception& e) {
-            ++errorCount;
         }
     }
-}
 
-void runBenchmark() {
-    std::vector<int> moves = { 0, 1, 0, 1, 0, 1, 0 };
-    constexpr int numberOfGames = 1'000'000'000;
+    // Repeats body after the warm-up runs; body returns one sample and may fill in counters
+    template<typename Body>
+    BenchmarkResult measure(std::string name, std::string unit, const BenchmarkOptions& options, Body&& body) {
+        BenchmarkResult result{std::move(name), std::move(unit), {}, {}};
+        for (unsigned i = 0; i < options.warmup; ++i) {
+            (void)body(result);
+        }
+        for (unsigned i = 0; i < options.repetitions; ++i) {
+            result.samples.push_back(body(result));
+        }
+        return result;
+    }
+
+    // Average time of one call of op over a batch large enough to swamp the clock overhead
+    template<typename Op>
+    double nanosecondsPerOp(const uint64_t operations, Op&& op) {
+        const auto start = Clock::now();
+        for (uint64_t i = 0; i < operations; ++i) {
+            op(i);
+        }
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / static_cast<double>(operations);
+    }
 
-    // Get the number of available CPU cores
-    const unsigned int numCores = std::thread::hardware_concurrency();
-    std::println("Using {} CPU cores", numCores);
+    double milliseconds(const std::chrono::microseconds time) {
+        return static_cast<double>(time.count()) / 1000.0;
+    }
 
-    // Calculate games per thread
-    const int gamesPerThread = numberOfGames / numCores;
-    const int remainingGames = numberOfGames % numCores;
+    // Board micro benchmarks on a board size that selects the wanted backend
+    BenchmarkResult boardPlace(const std::string& name, const uint16_t width, const uint16_t height,
+                               const BoardBackend backend, const BenchmarkOptions& options) {
+        return measure(name, "ns/op", options, [width, height, backend](BenchmarkResult&) {
+            Board board(width, height, backend);
+            const uint64_t cells = board.maxMoves;
+            // Fills the board row by row, then empties it; one operation is a place or an undo
+            return nanosecondsPerOp(1'000'000, [&](const uint64_t i) {
+                const auto phase = i % (2 * cells);
+                const auto col = static_cast<uint16_t>(phase % width);
+                if (phase < cells) {
+                    sink = sink + board.place(col, static_cast<uint8_t>(1 + phase % 2)).has_value();
+                } else {
+                    sink = sink + board.undo(col);
+                }
+            });
+        });
+    }
 
-    std::vector<std::thread> threads;
-    std::atomic<int> errorCount(0);
+    // Half-filled board without a winner and the cells played, in order
+    std::pair<Game, std::vector<std::pair<uint16_t, uint16_t>>>
+    halfFilledPosition(const uint16_t width, const uint16_t height, const BoardBackend backend = BoardBackend::AUTO) {
+        Game game(width, height, 2, backend);
+        std::vector<std::pair<uint16_t, uint16_t>> playedCells;
+        for (uint16_t i = 0; playedCells.size() < static_cast<std::size_t>(width * height / 2); ++i) {
+            // Stagger the columns and skip winning moves so the game stays undecided
+            const auto col = static_cast<uint16_t>((i * 3 + i / width) % width);
+            if (!game.board.canPlace(col) || game.isWinningMove(col)) continue;
+            if (game.place(col)) break;
+            playedCells.emplace_back(static_cast<uint16_t>(game.board.height - game.board.heights[col]), col);
+        }
+        return {std::move(game), std::move(playedCells)};
+    }
 
-    const auto start = std::chrono::high_resolution_clock::now();
+    BenchmarkResult boardCheckWin(const std::string& name, const uint16_t width, const uint16_t height,
+                                  const BoardBackend backend, const bool detailed, const BenchmarkOptions& options) {
+        const auto position = halfFilledPosition(width, height, backend);
+        const auto& board = position.first.board;
+        const auto& playedCells = position.second;
+        return measure(name, "ns/op", options, [&](BenchmarkResult&) {
+            return nanosecondsPerOp(1'000'000, [&](const uint64_t i) {
+                const auto [row, col] = playedCells[i % playedCells.size()];
+                if (detailed) {
+                    sink = sink + board.checkWinDetailed(row, col).hasWon;
+                } else {
+                    sink = sink + board.checkWin({row, col}).win;
+                }
+            });
+        });
+    }
 
-    // Launch threads
-    for (unsigned int i = 0; i < numCores; ++i) {
-        int threadGames = gamesPerThread + (i == numCores - 1 ? remainingGames : 0);
-        threads.emplace_back(runGameBatch, threadGames, std::ref(moves), std::ref(errorCount));
+    BenchmarkResult boardPlay(const std::string& name, const uint16_t width, const uint16_t height,
+                              const BoardBackend backend, const BenchmarkOptions& options) {
+        const auto playedCells = halfFilledPosition(width, height, backend).second;
+        return measure(name, "ns/op", options, [&](BenchmarkResult&) {
+            Board board(width, height, backend);
+            const uint64_t count = playedCells.size();
+            // Plays the half-filled position forwards with a win check after every piece, then takes it
+            // back in reverse order the way the search does; one operation is a place or an undo
+            return nanosecondsPerOp(1'000'000, [&](const uint64_t i) {
+                const auto phase = i % (2 * count);
+                if (phase < count) {
+                    const auto position = board.place(playedCells[phase].second, static_cast<uint8_t>(1 + phase % 2));
+                    sink = sink + board.checkWin(*position).win;
+                } else {
+                    sink = sink + board.undo(playedCells[2 * count - 1 - phase].second);
+                }
+            });
+        });
     }
 
-    // Wait for all threads to complete
-    for (auto& thread : threads) {
-        thread.join();
+    // Copies a half-filled game the way search threads and pondering take their own copies
+    BenchmarkResult gameCopy(const std::string& name, const uint16_t width, const uint16_t height,
+                             const BoardBackend backend, const BenchmarkOptions& options) {
+        const auto game = halfFilledPosition(width, height, backend).first;
+        return measure(name, "ns/op", options, [&game](BenchmarkResult&) {
+            return nanosecondsPerOp(1'000'000, [&](const uint64_t) {
+                const Game copy(game);
+                sink = sink + copy.board.movesPlayed;
+            });
+        });
     }
 
-    const auto end = std::chrono::high_resolution_clock::now();
-    const std::chrono::duration<double> duration = end - start;
+    BenchmarkResult fixedPlace(const BenchmarkOptions& options) {
+        const auto playedCells = halfFilledPosition(StandardGame::width, StandardGame::height).second;
+        return measure("micro.fixed.place", "ns/op", options, [&playedCells](BenchmarkResult&) {
+            StandardGame game;
+            const uint64_t count = playedCells.size();
+            // Plays the half-filled position forwards, then takes it back; one operation is a place
+            // (including its win check) or an unplace
+            return nanosecondsPerOp(1'000'000, [&](const uint64_t i) {
+                const auto phase = i % (2 * count);
+                if (phase < count) {
+                    sink = sink + game.place(playedCells[phase].second).has_value();
+                } else {
+                    game.unplace(playedCells[2 * count - 1 - phase].second);
+                }
+            });
+        });
+    }
 
-    std::println("{} games took {} seconds", numberOfGames, duration.count());
-    if (errorCount > 0) {
-        std::println("Encountered {} errors during simulation", errorCount.load());
+    // Cycles through the strength positions; a single position would let the compiler hoist the call
+    template<typename GameType>
+    BenchmarkResult evaluate(const std::string& name, const GameType& emptyGame, const BenchmarkOptions& options) {
+        std::vector<GameType> games;
+        for (const auto& position : STRENGTH_POSITIONS) {
+            games.push_back(emptyGame);
+            playMoves(games.back(), position.moves);
+        }
+        const Solver<GameType> solver(1, 1);
+        return measure(name, "ns/op", options, [&](BenchmarkResult&) {
+            return nanosecondsPerOp(1'000'000, [&](const uint64_t i) {
+                sink = sink + static_cast<uint64_t>(solver.evaluate(games[i % STRENGTH_POSITIONS.size()]));
+            });
+        });
     }
-}
\ No newline at end of file
+
+    // Search quality figures next to the timings, so a speedup from searching fewer nodes is visible as such
+    void addSearchStats(BenchmarkResult& result, const SearchStats& stats) {
+        if constexpr (SearchStats::enabled) {
+            result.counters["tt_hit_rate"] = stats.ttHitRate();
+            result.counters["first_move_cutoff_rate"] = stats.firstMoveCutoffRate();
+            result.counters["effective_branching_factor"] = stats.effectiveBranchingFactor();
+        }
+    }
+
+    BenchmarkResult search(const BenchmarkPosition& position, const BenchmarkOptions& options) {
+        StandardGame game;
+        playMoves(game, position.moves);
+        return measure(std::format("search.{}", position.name), "ms", options, [&](BenchmarkResult& result) {
+            Solver<StandardGame> solver(TranspositionTable::DEFAULT_SIZE_MB, 1);  // Fresh table every repetition
+            const auto searchResult = solver.search(game, {.maxDepth = options.searchDepth});
+            result.counters["nodes"] = static_cast<double>(searchResult.nodes);
+            result.counters["depth"] = searchResult.depth;
+            for (std::size_t depth = 1; depth <= searchResult.depthTimes.size(); ++depth) {
+                result.counters[std::format("time_to_depth_{:02}_ms", depth)] = milliseconds(searchResult.depthTimes[depth - 1]);
+            }
+            addSearchStats(result, searchResult.stats);
+            return milliseconds(searchResult.time);
+        });
+    }
+
+    // Play strength per node: every position is searched to depths 1 to searchDepth on one table, as
+    // iterative deepening would, and charged the nodes spent until its chosen column keeps the exact
+    // outcome at every deeper depth (all of them if it never settles). The sample is the total.
+    BenchmarkResult strength(const BenchmarkOptions& options) {
+        const int maxDepth = std::max(options.searchDepth, 1);
+        return measure("strength.nodes", "nodes", options, [&](BenchmarkResult& result) {
+            std::vector<unsigned> correctAtDepth(maxDepth, 0);
+            double totalNodes = 0;
+            for (const auto& position : STRENGTH_POSITIONS) {
+                StandardGame game;
+                playMoves(game, position.moves);
+                Solver<StandardGame> solver(16, 1);
+                unsigned long long nodes = 0, settledNodes = 0;
+                bool settled = false;
+                for (int depth = 1; depth <= maxDepth; ++depth) {
+                    const auto searchResult = solver.search(game, {.maxDepth = depth});
+                    nodes += searchResult.nodes;
+                    const bool correct = position.bestColumns.contains(static_cast<char>('0' + searchResult.bestMove));
+                    correctAtDepth[depth - 1] += correct;
+                    if (correct && !settled) settledNodes = nodes;
+                    settled = correct;
+                }
+                totalNodes += static_cast<double>(settled ? settledNodes : nodes);
+            }
+            for (int depth = 1; depth <= maxDepth; ++depth) {
+                result.counters[std::format("correct_at_depth_{:02}", depth)] = correctAtDepth[depth - 1];
+            }
+            result.counters["positions"] = STRENGTH_POSITIONS.size();
+            return totalNodes;
+        });
+    }
+
+    BenchmarkResult threadScaling(const unsigned threads, const BenchmarkOptions& options) {
+        StandardGame game;
+        playMoves(game, MIDGAME_POSITION);
+        return measure(std::format("threads.{}", threads), "ms", options, [&](BenchmarkResult& result) {
+            Solver<StandardGame> solver(TranspositionTable::DEFAULT_SIZE_MB, threads);
+            const auto searchResult = solver.search(game, {.maxDepth = options.searchDepth});
+            result.counters["nodes"] = static_cast<double>(searchResult.nodes);
+            return milliseconds(searchResult.time);
+        });
+    }
+
+    BenchmarkResult playouts(const BenchmarkOptions& options) {
+        constexpr uint64_t gamesPerThread = 1 << 18;
+        return measure("playout.batch", "ns/game", options, [&](BenchmarkResult& result) {
+            PlayoutStats stats;
+            ThreadPool::global().ensureWorkers(options.maxThreads - 1);
+            const auto start = Clock::now();
+            parallelFor(0, options.maxThreads, [&](const std::size_t batch) {
+                runGameBatch(gamesPerThread, batch, stats);
+            });
+            const std::chrono::duration<double, std::nano> duration = Clock::now() - start;
+            result.counters["threads"] = options.maxThreads;
+            return duration.count() / static_cast<double>(gamesPerThread * options.maxThreads);
+        });
+    }
+
+    template<typename GameType>
+    BenchmarkResult monteCarlo(const std::string& name, const GameType& game, const unsigned threads,
+                               const BenchmarkOptions& options) {
+        constexpr unsigned long long playouts = 50000;
+        MCTS<GameType> mcts(TranspositionTable::DEFAULT_SIZE_MB, threads);
+        return measure(name, "ns/playout", options, [&](BenchmarkResult& result) {
+            const auto mctsResult = mcts.search(game, {.nodes = playouts * threads});
+            result.counters["threads"] = threads;
+            return static_cast<double>(mctsResult.time.count()) * 1000.0 / static_cast<double>(mctsResult.playouts);
+        });
+    }
+
+    // Three-player search from the empty board; max^n prunes far less, so it gets a shallower default depth
+    BenchmarkResult multiplayer(const std::string& name, const MultiplayerStrategy strategy, const int depth,
+                                const BenchmarkOptions& options) {
+        const Game game(7, 6, 3);
+        return measure(name, "ms", options, [&](BenchmarkResult& result) {
+            MultiplayerSolver<Game> solver(strategy);  // Fresh table every repetition
+            const auto searchResult = solver.search(game, {.maxDepth = depth});
+            result.counters["nodes"] = static_cast<double>(searchResult.nodes);
+            result.counters["depth"] = searchResult.depth;
+            addSearchStats(result, searchResult.stats);
+            return milliseconds(searchResult.time);
+        });
+    }
+
+    BenchmarkResult exact(const BenchmarkPosition& position, const BenchmarkOptions& options) {
+        StandardGame game;
+        playMoves(game, position.moves);
+        ExactSolver solver;
+        return measure(std::format("exact.{}", position.name), "ms", options, [&](BenchmarkResult& result) {
+            solver.reset();
+            const auto exactResult = solver.solve(game);
+            result.counters["nodes"] = static_cast<double>(exactResult.nodes);
+            result.counters["score"] = exactResult.score;
+            return milliseconds(exactResult.time);
+        });
+    }
+
+    struct RegisteredBenchmark {
+        std::string name;
+        std::function<BenchmarkResult(const BenchmarkOptions&)> run;
+    };
+
+    std::vector<RegisteredBenchmark> registry(const BenchmarkOptions& options) {
+        std::vector<RegisteredBenchmark> benchmarks;
+        const auto add = [&benchmarks](std::string name, std::function<BenchmarkResult(const BenchmarkOptions&)> run) {
+            benchmarks.push_back({std::move(name), std::move(run)});
+        };
+
+        // 7x6 fits a bitboard, 9x7 does not and runs on the cell backend unless packed cells are asked for
+        for (const auto& [name, width, height, backend] : {std::tuple{"bitboard", 7, 6, BoardBackend::AUTO},
+                                                           std::tuple{"cells", 9, 7, BoardBackend::AUTO},
+                                                           std::tuple{"packed", 9, 7, BoardBackend::PACKED}}) {
+            const auto w = static_cast<uint16_t>(width), h = static_cast<uint16_t>(height);
+            const auto place = std::format("micro.board.place/{}", name);
+            const auto win = std::format("micro.board.checkWin/{}", name);
+            const auto detailed = std::format("micro.board.checkWinDetailed/{}", name);
+            const auto play = std::format("micro.board.play/{}", name);
+            const auto copy = std::format("micro.game.copy/{}", name);
+            const auto b = backend;
+            add(place, [=](const auto& o) { return boardPlace(place, w, h, b, o); });
+            add(play, [=](const auto& o) { return boardPlay(play, w, h, b, o); });
+            add(win, [=](const auto& o) { return boardCheckWin(win, w, h, b, false, o); });
+            add(detailed, [=](const auto& o) { return boardCheckWin(detailed, w, h, b, true, o); });
+            add(copy, [=](const auto& o) { return gameCopy(copy, w, h, b, o); });
+        }
+        add("micro.fixed.place", fixedPlace);
+        add("micro.evaluate/dynamic", [](const auto& o) { return evaluate("micro.evaluate/dynamic", Game(7, 6, 2), o); });
+        add("micro.evaluate/fixed", [](const auto& o) { return evaluate("micro.evaluate/fixed", StandardGame{}, o); });
+
+        for (const auto& position : SEARCH_POSITIONS) {
+            add(std::format("search.{}", position.name), [&position](const auto& o) { return search(position, o); });
+        }
+        add("strength.nodes", strength);
+
+        // Powers of two up to the core count, plus the core count itself
+        for (unsigned threads = 1; threads <= options.maxThreads; threads *= 2) {
+            add(std::format("threads.{}", threads), [threads](const auto& o) { return threadScaling(threads, o); });
+        }
+        if (!std::has_single_bit(options.maxThreads)) {
+            add(std::format("threads.{}", options.maxThreads), [](const auto& o) { return threadScaling(o.maxThreads, o); });
+        }
+
+        add("playout.batch", playouts);
+
+        add("multi.paranoid.3p", [](const auto& o) {
+            return multiplayer("multi.paranoid.3p", MultiplayerStrategy::PARANOID, o.searchDepth - 4, o);
+        });
+        add("multi.maxn.3p", [](const auto& o) {
+            return multiplayer("multi.maxn.3p", MultiplayerStrategy::MAXN, o.searchDepth / 2, o);
+        });
+
+        add("mcts.2p", [](const auto& o) { return monteCarlo("mcts.2p", StandardGame{}, 1, o); });
+        add("mcts.3p", [](const auto& o) { return monteCarlo("mcts.3p", Game(7, 6, 3), 1, o); });
+        add("mcts.3p/all-cores", [](const auto& o) { return monteCarlo("mcts.3p/all-cores", Game(7, 6, 3), o.maxThreads, o); });
+
+        for (const auto& position : EXACT_POSITIONS) {
+            add(std::format("exact.{}", position.name), [&position](const auto& o) { return exact(position, o); });
+        }
+        return benchmarks;
+    }
+
+    // Rates derived from the median sample so they are as stable as the median itself
+    void deriveCounters(BenchmarkResult& result, const std::vector<BenchmarkResult>& finished) {
+        const double median = result.percentile(50);
+        if (result.counters.contains("nodes") && result.unit == "ms" && median > 0) {
+            result.counters["nodes_per_second"] = result.counters["nodes"] * 1000.0 / median;
+        }
+        if (result.unit == "ns/game" && median > 0) {
+            result.counters["games_per_second"] = 1e9 / median;
+        }
+        if (result.unit == "ns/playout" && median > 0) {
+            result.counters["playouts_per_second"] = 1e9 / median;
+        }
+        if (result.name.starts_with("threads.")) {
+            const auto single = std::ranges::find(finished, std::string("threads.1"), &BenchmarkResult::name);
+            if (single != finished.end() && median > 0) {
+                result.counters["speedup"] = single->percentile(50) / median;
+            }
+        }
+    }
+
+    std::string jsonNumber(const double value) {
+        return std::isfinite(value) ? std::format("{}", value) : "null";
+    }
+}
+
+void runGameBatch(const uint64_t numGames, const uint64_t seed, PlayoutStats& stats) {
+    BatchSimulator simulator(BATCH_SIZE);
+    uint64_t playerOneWins = 0, playerTwoWins = 0, draws = 0, moves = 0;
+
+    for (uint64_t played = 0, batch = 0; played < numGames; played += simulator.size(), ++batch) {
+        simulator.reset();
+        simulator.playRandom(seed * 0x9E3779B97F4A7C15ULL + batch);
+
+        const auto games = static_cast<std::size_t>(std::min<uint64_t>(simulator.size(), numGames - played));
+        for (std::size_t i = 0; i < games; ++i) {
+            const auto winner = simulator.winner(i);
+            playerOneWins += winner == 1;
+            playerTwoWins += winner == 2;
+            draws += winner == 0;
+            moves += simulator.movesPlayed(i);
+        }
+    }
+
+    stats.playerOneWins += playerOneWins;
+    stats.playerTwoWins += playerTwoWins;
+    stats.draws += draws;
+    stats.moves += moves;
+}
+
+double BenchmarkResult::percentile(const double p) const {
+    if (samples.empty()) return 0.0;
+    std::vector<double> sorted(samples);
+    std::ranges::sort(sorted);
+    const double rank = std::clamp(p, 0.0, 100.0) / 100.0 * static_cast<double>(sorted.size() - 1);
+    const auto lower = static_cast<std::size_t>(rank);
+    const auto upper = std::min(lower + 1, sorted.size() - 1);
+    return sorted[lower] + (sorted[upper] - sorted[lower]) * (rank - static_cast<double>(lower));
+}
+
+double BenchmarkResult::mean() const {
+    if (samples.empty()) return 0.0;
+    return std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+}
+
+std::vector<std::string> benchmarkNames() {
+    std::vector<std::string> names;
+    for (const auto& benchmark : registry(BenchmarkOptions{})) {
+        names.push_back(benchmark.name);
+    }
+    return names;
+}
+
+std::vector<BenchmarkResult> runBenchmarks(const BenchmarkOptions& options) {
+    std::vector<BenchmarkResult> results;
+    for (const auto& benchmark : registry(options)) {
+        if (!benchmark.name.contains(options.filter)) continue;
+
+        auto result = benchmark.run(options);
+        deriveCounters(result, results);
+        std::print("{:<40} p50 {:>12.3f}  p90 {:>12.3f}  p99 {:>12.3f}  {}", result.name, result.percentile(50),
+                   result.percentile(90), result.percentile(99), result.unit);
+        for (const auto* counter : {"nodes_per_second", "games_per_second", "playouts_per_second", "speedup"}) {
+            if (const auto it = result.counters.find(counter); it != result.counters.end()) {
+                std::print("  {} {:.2f}", counter, it->second);
+            }
+        }
+        std::println("");
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+std::string benchmarksToJson(const std::vector<BenchmarkResult>& results, const BenchmarkOptions& options) {
+    std::string json = "{\n";
+    json += std::format("  \"context\": {{\"threads\": {}, \"warmup\": {}, \"repetitions\": {}, \"search_depth\": {}, "
+                        "\"simd\": \"{}\"}},\n",
+                        options.maxThreads, options.warmup, options.repetitions, options.searchDepth,
+                        BatchSimulator::backend());
+    json += "  \"benchmarks\": [";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        json += i == 0 ? "\n" : ",\n";
+        json += std::format("    {{\"name\": \"{}\", \"unit\": \"{}\", \"min\": {}, \"p50\": {}, \"p90\": {}, "
+                            "\"p99\": {}, \"max\": {}, \"mean\": {}, \"samples\": [",
+                            result.name, result.unit, jsonNumber(result.percentile(0)),
+                            jsonNumber(result.percentile(50)), jsonNumber(result.percentile(90)),
+                            jsonNumber(result.percentile(99)), jsonNumber(result.percentile(100)),
+                            jsonNumber(result.mean()));
+        for (std::size_t j = 0; j < result.samples.size(); ++j) {
+            json += (j == 0 ? "" : ", ") + jsonNumber(result.samples[j]);
+        }
+        json += "], \"counters\": {";
+        bool first = true;
+        for (const auto& [counter, value] : result.counters) {
+            json += std::format("{}\"{}\": {}", first ? "" : ", ", counter, jsonNumber(value));
+            first = false;
+        }
+        json += "}}";
+    }
+    json += "\n  ]\n}\n";
+    return json;
+}
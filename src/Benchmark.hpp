@@ -1,4 +1,46 @@
 #pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
 
-void runGameBatch(const int numGames, const std::vector<int>& moves, std::atomic<int>& errorCount);
-void runBenchmark();
\ No newline at end of file
+// Win/draw tallies shared by the playout benchmark threads
+struct PlayoutStats {
+    std::atomic<uint64_t> playerOneWins{0};
+    std::atomic<uint64_t> playerTwoWins{0};
+    std::atomic<uint64_t> draws{0};
+    std::atomic<uint64_t> moves{0};
+};
+
+void runGameBatch(uint64_t numGames, uint64_t seed, PlayoutStats& stats);
+
+struct BenchmarkOptions {
+    std::string filter;  // Only benchmarks whose name contains this run; empty runs all
+    unsigned warmup{2};
+    unsigned repetitions{10};
+    int searchDepth{12};
+    unsigned maxThreads{std::max(1u, std::thread::hardware_concurrency())};
+};
+
+// Samples of one benchmark, one per repetition after warm-up
+struct BenchmarkResult {
+    std::string name;
+    std::string unit;
+    std::vector<double> samples;
+    std::map<std::string, double> counters;  // Derived figures such as nodes or nodes/s
+
+    // Linear interpolation between the closest ranks, p in [0, 100]
+    [[nodiscard]] double percentile(double p) const;
+    [[nodiscard]] double mean() const;
+};
+
+// Names of every registered benchmark, grouped by prefix: micro., search., strength., threads., playout., multi., mcts., exact.
+[[nodiscard]] std::vector<std::string> benchmarkNames();
+
+// Runs the benchmarks selected by options.filter, printing one line per benchmark as it finishes
+[[nodiscard]] std::vector<BenchmarkResult> runBenchmarks(const BenchmarkOptions& options);
+
+[[nodiscard]] std::string benchmarksToJson(const std::vector<BenchmarkResult>& results, const BenchmarkOptions& options);
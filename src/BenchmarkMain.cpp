@@ -0,0 +1,60 @@
+// Benchmark runner: micro benchmarks of the board primitives, fixed-position searches, thread
+// scaling, batch playouts and exact solves, with optional JSON output for comparing commits.
+//
+// Usage: ConnectFourBench [--filter TEXT] [--list] [--json PATH] [--warmup N] [--repetitions N]
+//                         [--depth D] [--threads T]
+
+#include <fstream>
+#include <print>
+#include <stdexcept>
+#include <string>
+
+#include "Benchmark.hpp"
+
+int main(int argc, char** argv) {
+    BenchmarkOptions options;
+    std::string jsonPath;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            const auto value = [&]() -> std::string {
+                if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + arg);
+                return argv[++i];
+            };
+            if (arg == "--list") {
+                for (const auto& name : benchmarkNames()) {
+                    std::println("{}", name);
+                }
+                return 0;
+            }
+            if (arg == "--filter") options.filter = value();
+            else if (arg == "--json") jsonPath = value();
+            else if (arg == "--warmup") options.warmup = static_cast<unsigned>(std::stoi(value()));
+            else if (arg == "--repetitions") options.repetitions = static_cast<unsigned>(std::max(1, std::stoi(value())));
+            else if (arg == "--depth") options.searchDepth = std::stoi(value());
+            else if (arg == "--threads") options.maxThreads = static_cast<unsigned>(std::max(1, std::stoi(value())));
+            else throw std::invalid_argument("Unknown argument " + arg);
+        }
+    } catch (const std::exception& e) {
+        std::println("{}", e.what());
+        std::println("Usage: ConnectFourBench [--filter TEXT] [--list] [--json PATH] [--warmup N] [--repetitions N] "
+                     "[--depth D] [--threads T]");
+        return 1;
+    }
+
+    const auto results = runBenchmarks(options);
+    if (results.empty()) {
+        std::println("No benchmark matches \"{}\"", options.filter);
+        return 1;
+    }
+
+    if (!jsonPath.empty()) {
+        std::ofstream out(jsonPath);
+        out << benchmarksToJson(results, options);
+        if (!out) {
+            std::println("Failed to write {}", jsonPath);
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -1,6 +1,6 @@
 #include "Board.hpp"
 #include <algorithm>
-#include <ranges>
+#include <array>
 
 namespace {
     constexpr GameResult DRAW_RESULT = {false, true, std::nullopt};
@@ -9,6 +9,42 @@ namespace {
     constexpr GameResult WIN_RESULT(uint8_t player) {
         return {true, false, player};
     }
+
+    // Row/column steps for horizontal, vertical, diagonal (↘) and diagonal (↙) lines
+    constexpr std::array<std::pair<int, int>, 4> LINE_DIRECTIONS = {{{0, 1}, {1, 0}, {1, 1}, {1, -1}}};
+
+    // Index distance of one step along a line direction in the bordered run grid
+    constexpr std::ptrdiff_t runStep(const std::size_t direction, const uint16_t width) noexcept {
+        return static_cast<std::ptrdiff_t>(LINE_DIRECTIONS[direction].first) * (width + 2) + LINE_DIRECTIONS[direction].second;
+    }
+
+    // Packed backend SWAR constants: the lowest bit of every 3-bit field of a word, of a 7-cell window,
+    // and the middle cell of a window
+    constexpr uint64_t FIELD_LOWS = 0x1249249249249249ull;
+    constexpr uint64_t WINDOW_BITS = (uint64_t{1} << 21) - 1;
+    constexpr uint64_t WINDOW_LOWS = FIELD_LOWS & WINDOW_BITS;
+    constexpr uint64_t WINDOW_CENTER = uint64_t{1} << 9;
+
+    // One bit (the lowest of its field) for every cell of a packed word holding player
+    constexpr uint64_t packedMatches(const uint64_t word, const uint8_t player) noexcept {
+        const auto difference = word ^ (FIELD_LOWS * player);
+        return ~(difference | difference >> 1 | difference >> 2) & FIELD_LOWS;
+    }
+
+    // Moves the fields of a window down by cells (up for negative cells), dropping what leaves the window
+    constexpr uint64_t shiftWindow(const uint64_t window, const int cells) noexcept {
+        return cells >= 0 ? window >> (3 * cells) : (window << (-3 * cells)) & WINDOW_BITS;
+    }
+}
+
+BoardBackend Board::resolveBackend(const uint16_t width, const uint16_t height, const BoardBackend backend) {
+    if (backend == BoardBackend::AUTO) {
+        return fitsBitboard(width, height) ? BoardBackend::BITBOARD : BoardBackend::CELLS;
+    }
+    if (backend == BoardBackend::BITBOARD && !fitsBitboard(width, height)) {
+        throw std::invalid_argument("Board is too large for the bitboard backend");
+    }
+    return backend;
 }
 
 bool Board::canPlace(const uint16_t col) const noexcept {
@@ -19,147 +55,295 @@ bool Board::canPlace(const uint16_t col) const noexcept {
 }
 
 
-std::expected<std::pair<uint16_t, uint16_t>, std::string>
+std::expected<std::pair<uint16_t, uint16_t>, PlaceError>
 Board::place(uint16_t col, const uint8_t player) noexcept {
     if (col >= width) {
-        return std::unexpected("Column out of bounds");
+        return std::unexpected(PlaceError::COLUMN_OUT_OF_BOUNDS);
     }
 
     const auto height = heights[col];
     if (height >= this->height) {
-        return std::unexpected("Column is full");
+        return std::unexpected(PlaceError::COLUMN_FULL);
     }
 
     const auto row = this->height - 1 - height;
-    board[row * width + col] = player;
+    if (backendKind == BoardBackend::BITBOARD) {
+        const auto bit = uint64_t{1} << (col * (this->height + 1) + height);
+        playerMasks[player - 1] |= bit;
+        occupied |= bit;
+    } else if (backendKind == BoardBackend::PACKED) {
+        packedWord(col, height) |= static_cast<uint64_t>(player) << packedShift(height);
+    } else {
+        board[row * width + col] = player;
+        updateRuns(row, col, player);
+    }
     heights[col] = height + 1;
+    hash ^= zobrist::pieceKey(col * this->height + height, player);
+    mirrorHash ^= zobrist::pieceKey((width - 1 - col) * this->height + height, player);
     movesPlayed++;
     return std::pair(row, col);
 }
 
+uint8_t Board::undo(const uint16_t col) noexcept {
+    const auto height = heights[col];
+    if (height == 0) return 0;
+
+    const auto row = this->height - height;
+    const auto player = cell(row, col);
+    if (backendKind == BoardBackend::BITBOARD) {
+        const auto bit = bitAt(row, col);
+        playerMasks[player - 1] &= ~bit;
+        occupied &= ~bit;
+    } else if (backendKind == BoardBackend::PACKED) {
+        packedWord(col, height - 1) &= ~(uint64_t{7} << packedShift(height - 1));
+    } else {
+        removeRuns(row, col, player);
+        board[row * width + col] = 0;
+    }
+    heights[col] = height - 1;
+    hash ^= zobrist::pieceKey(col * this->height + height - 1, player);
+    mirrorHash ^= zobrist::pieceKey((width - 1 - col) * this->height + height - 1, player);
+    movesPlayed--;
+    return player;
+}
+
+bool Board::isWinningMove(const uint16_t col, const uint8_t player) const noexcept {
+    const auto height = heights[col];
+    if (height >= this->height) return false;
+
+    const auto row = this->height - 1 - height;
+    if (backendKind == BoardBackend::BITBOARD) {
+        return hasFourInMask(playerMasks[player - 1] | bitAt(row, col), this->height);
+    }
+    if (backendKind == BoardBackend::PACKED) {
+        return packedLine(col, height, player, true);
+    }
+
+    const auto index = runIndex(row, col);
+    for (std::size_t direction = 0; direction < LINE_DIRECTIONS.size(); ++direction) {
+        if (const auto [behind, ahead] = runsAround(index, direction, player); behind + 1 + ahead >= 4) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint16_t Board::countWinningMoves(const uint8_t player) const noexcept {
+    uint16_t count = 0;
+    for (uint16_t col = 0; col < width; ++col) {
+        count += isWinningMove(col, player);
+    }
+    return count;
+}
+
+std::pair<int, int> Board::runsAround(const std::size_t index, const std::size_t direction,
+                                      const uint8_t player) const noexcept {
+    // The neighbours of the cell end their runs there, so their counts towards the cell are exact
+    const auto step = runStep(direction, width);
+    return {runOwners[index - step] == player ? runs[index - step].behind[direction] + 1 : 0,
+            runOwners[index + step] == player ? runs[index + step].ahead[direction] + 1 : 0};
+}
+
+int Board::walkRun(const std::size_t index, const std::ptrdiff_t step, const uint8_t player) const noexcept {
+    int count = 0;
+    for (auto cell = index + step; runOwners[cell] == player; cell += step) {
+        ++count;
+    }
+    return count;
+}
+
+void Board::updateRuns(const uint16_t row, const uint16_t col, const uint8_t player) noexcept {
+    const auto index = runIndex(row, col);
+    int longestLine = 1;
+    for (std::size_t direction = 0; direction < LINE_DIRECTIONS.size(); ++direction) {
+        const auto [behind, ahead] = runsAround(index, direction, player);
+        const auto step = runStep(direction, width);
+        // The joined run ends at the far ends of the runs on either side (or at the new piece itself)
+        runs[index - behind * step].ahead[direction] = static_cast<uint16_t>(behind + ahead);
+        runs[index + ahead * step].behind[direction] = static_cast<uint16_t>(behind + ahead);
+        longestLine = std::max(longestLine, behind + 1 + ahead);
+    }
+    runOwners[index] = player;
+    placed.push_back({static_cast<uint32_t>(index), static_cast<uint16_t>(longestLine)});
+}
+
+void Board::removeRuns(const uint16_t row, const uint16_t col, const uint8_t player) noexcept {
+    const auto index = runIndex(row, col);
+    const bool lastPlaced = !placed.empty() && placed.back().index == index;
+    runOwners[index] = 0;
+    for (std::size_t direction = 0; direction < LINE_DIRECTIONS.size(); ++direction) {
+        const auto step = runStep(direction, width);
+        // Pieces taken back out of order may split runs whose middle counts are stale, so those walk the line
+        const auto [behind, ahead] = lastPlaced
+            ? runsAround(index, direction, player)
+            : std::pair(walkRun(index, -step, player), walkRun(index, step, player));
+        if (behind > 0) {
+            runs[index - step].behind[direction] = static_cast<uint16_t>(behind - 1);
+            runs[index - behind * step].ahead[direction] = static_cast<uint16_t>(behind - 1);
+        }
+        if (ahead > 0) {
+            runs[index + step].ahead[direction] = static_cast<uint16_t>(ahead - 1);
+            runs[index + ahead * step].behind[direction] = static_cast<uint16_t>(ahead - 1);
+        }
+    }
+    if (lastPlaced) {
+        placed.pop_back();
+    } else {
+        placed.clear();
+    }
+}
+
+int Board::countDirection(const uint16_t row, const uint16_t col, const int dRow, const int dCol,
+                          const uint8_t player) const noexcept {
+    int count = 0;
+    for (auto i = 1; i < 4; ++i) {
+        const uint16_t newRow = row + dRow * i;
+        const uint16_t newCol = col + dCol * i;
+        if (!isValidPosition(newRow, newCol, height, width) || board[newRow * width + newCol] != player) {
+            break;
+        }
+        ++count;
+    }
+    return count;
+}
+
 GameResult Board::checkWin(std::pair<uint16_t, uint16_t> lastMove) const noexcept {
     // Early exit if win is impossible
     if (movesPlayed < 7) return NO_WIN_RESULT;
 
+    if (backendKind == BoardBackend::BITBOARD) return checkWinBitboard(lastMove);
+
     const auto [row, col] = lastMove;
-    const auto pos = row * width + col;
-    const auto player = board[pos];
+    if (backendKind == BoardBackend::PACKED) {
+        const auto player = cell(row, col);
+        if (player != 0 && packedLine(col, height - 1 - row, player, false)) {
+            return WIN_RESULT(player);
+        }
+        return movesPlayed == maxMoves ? DRAW_RESULT : NO_WIN_RESULT;
+    }
+
+    const auto player = board[row * width + col];
 
     if (player == 0) return NO_WIN_RESULT;
 
-    // Horizontal check using ranges
-    const auto rowStart = row * width;
-    const auto rowView = std::span(board).subspan(rowStart, width);
-    
-    auto window = std::views::counted(rowView.begin() + std::max<int>(0, col - 3), 7);
-    auto consecutive = std::views::adjacent<4>(window);
-    
-    auto hasWin = std::ranges::any_of(consecutive, [player](const auto& group) {
-        const auto& [a, b, c, d] = group;
-        return a == player && b == player && c == player && d == player;
-    });
-
-    if (hasWin) return WIN_RESULT(player);
-
-    // Vertical check - only need to check down
-    if (row <= height - 4) {
-        if (auto vPos = pos + width; board[vPos] == player) {
-            vPos += width;
-            if (board[vPos] == player) {
-                vPos += width;
-                if (board[vPos] == player) {
-                    return WIN_RESULT(player);
-                }
+    // The most recent piece knows its longest line from place(), older ones are counted cell by cell
+    if (!placed.empty() && placed.back().index == runIndex(row, col)) {
+        if (placed.back().longestLine >= 4) {
+            return WIN_RESULT(player);
+        }
+    } else {
+        for (const auto& [dRow, dCol] : LINE_DIRECTIONS) {
+            if (1 + countDirection(row, col, dRow, dCol, player) + countDirection(row, col, -dRow, -dCol, player) >= 4) {
+                return WIN_RESULT(player);
             }
         }
     }
 
-    // Only do diagonal checks if we have enough space
-    if (row <= height - 4) {
-        // Diagonal check (↘)
-        if (col <= width - 4) {
-            if (auto dPos = pos + width + 1; board[dPos] == player) {
-                dPos += width + 1;
-                if (board[dPos] == player) {
-                    dPos += width + 1;
-                    if (board[dPos] == player) {
-                        return WIN_RESULT(player);
-                    }
-                }
-            }
-        }
+    return movesPlayed == maxMoves ? DRAW_RESULT : NO_WIN_RESULT;
+}
 
-        // Diagonal check (↙)
-        if (col >= 3) {
-            if (auto dPos = pos + width - 1; board[dPos] == player) {
-                dPos += width - 1;
-                if (board[dPos] == player) {
-                    dPos += width - 1;
-                    if (board[dPos] == player) {
-                        return WIN_RESULT(player);
-                    }
-                }
-            }
-        }
+GameResult Board::checkWinBitboard(const std::pair<uint16_t, uint16_t> lastMove) const noexcept {
+    const auto player = cell(lastMove.first, lastMove.second);
+    if (player == 0) return NO_WIN_RESULT;
+
+    // Only the mover can have completed a line, so a single mask needs checking
+    if (hasFourInMask(playerMasks[player - 1], height)) {
+        return WIN_RESULT(player);
     }
 
     return movesPlayed == maxMoves ? DRAW_RESULT : NO_WIN_RESULT;
 }
 
-WinResult Board::checkWinDetailed(const uint16_t rowPlayed, const uint16_t colPlayed) const noexcept {
-    const auto player = board[rowPlayed * width + colPlayed];
+bool Board::hasFourInMask(const uint64_t mask, const uint16_t height) noexcept {
+    // Vertical (1), horizontal (height + 1), diagonal ↗ (height + 2) and diagonal ↘ (height)
+    const unsigned columnStride = height + 1;
+    for (const unsigned shift : {1u, columnStride, columnStride + 1, columnStride - 1}) {
+        // No line of four fits a direction that long, and shifting by 64 or more is undefined
+        if (3 * shift >= 64) continue;
+        const auto pairs = mask & (mask >> shift);
+        if (pairs & (pairs >> (2 * shift))) {
+            return true;
+        }
+    }
+    return false;
+}
 
-    // Early exit if position is empty
-    if (player == 0) return {false, 0, {}};
+uint64_t Board::packedWindow(const int col, const int firstRow) const noexcept {
+    const int first = std::max(firstRow, 0);
+    if (col < 0 || col >= width || first >= height) return 0;
 
-    constexpr std::array<std::pair<int, int>, 4> directions = {{
-        {0, 1},  // horizontal
-        {1, 0},  // vertical
-        {1, 1},  // diagonal down (↘)
-        {1, -1}  // diagonal up (↗)
-    }};
+    // Cells below the board are shifted in as empty fields
+    const auto rowFromBottom = static_cast<uint32_t>(first);
+    const auto shift = packedShift(rowFromBottom);
+    auto cells = packedWord(static_cast<uint16_t>(col), rowFromBottom) >> shift;
+    if (shift > 63 - 21 && rowFromBottom / PACKED_CELLS + 1 < packedWords) {
+        cells |= packedWord(static_cast<uint16_t>(col), rowFromBottom + PACKED_CELLS) << (63 - shift);
+    }
+    return (cells << (3 * (first - firstRow))) & WINDOW_BITS;
+}
 
-    for (const auto& [dx, dy] : directions) {
-        std::vector<CellPosition> winningCells;
-        winningCells.reserve(4); // Reserve space for maximum possible winning cells
-        winningCells.push_back({rowPlayed, colPlayed});
-        auto count = 1;
+bool Board::packedLine(const uint16_t col, const uint32_t rowFromBottom, const uint8_t player,
+                       const bool assumePlaced) const noexcept {
+    // Seven columns of seven cells around the piece, one match bit per cell holding player
+    std::array<uint64_t, 7> matches{};
+    for (int offset = -3; offset <= 3; ++offset) {
+        matches[offset + 3] = packedMatches(packedWindow(col + offset, static_cast<int>(rowFromBottom) - 3), player) & WINDOW_LOWS;
+    }
+    if (assumePlaced) {
+        matches[3] |= WINDOW_CENTER;
+    }
 
-        // Check in the positive direction
-        for (auto i = 1; i < 4; ++i) {
-            const uint16_t newRow = rowPlayed + dx * i;
-            const uint16_t newCol = colPlayed + dy * i;
+    const auto vertical = matches[3];
+    if (vertical & vertical >> 3 & vertical >> 6 & vertical >> 9) {
+        return true;
+    }
 
-            if (!isValidPosition(newRow, newCol, height, width) ||
-                board[newRow * width + newCol] != player) {
-                break;
-            }
-            winningCells.push_back({newRow, newCol});
-            ++count;
-        }
+    // Horizontal, rising and falling lines side by side in one word: every window is shifted so the
+    // cell each line crosses in that column sits in the middle field, then four windows in a row are
+    // ANDed for all three lines at once
+    std::array<uint64_t, 7> lanes{};
+    for (int offset = -3; offset <= 3; ++offset) {
+        const auto window = matches[offset + 3];
+        lanes[offset + 3] = window | shiftWindow(window, offset) << 21 | shiftWindow(window, -offset) << 42;
+    }
+    uint64_t lines = 0;
+    for (std::size_t first = 0; first + 4 <= lanes.size(); ++first) {
+        lines |= lanes[first] & lanes[first + 1] & lanes[first + 2] & lanes[first + 3];
+    }
+    return (lines & (WINDOW_CENTER | WINDOW_CENTER << 21 | WINDOW_CENTER << 42)) != 0;
+}
 
-        // Check in the negative direction
-        for (auto i = 1; i < 4; ++i) {
-            const uint16_t newRow = rowPlayed - dx * i;
-            const uint16_t newCol = colPlayed - dy * i;
+WinResult Board::checkWinDetailed(const uint16_t rowPlayed, const uint16_t colPlayed) const noexcept {
+    const auto player = cell(rowPlayed, colPlayed);
 
-            if (!isValidPosition(newRow, newCol, height, width) ||
-                board[newRow * width + newCol] != player) {
-                break;
-            }
-            winningCells.push_back({newRow, newCol});
+    // Early exit if position is empty
+    if (player == 0) return {false, 0, {}};
+
+    // Runs are measured through cell() so both backends work; the cells are only collected for a win
+    const auto extent = [&](const int dRow, const int dCol) {
+        int count = 0;
+        for (auto i = 1; i < 4; ++i) {
+            const uint16_t newRow = rowPlayed + dRow * i;
+            const uint16_t newCol = colPlayed + dCol * i;
+            if (!isValidPosition(newRow, newCol, height, width) || cell(newRow, newCol) != player) break;
             ++count;
         }
+        return count;
+    };
 
-        if (count >= 4) {
-            // Sort winning cells by row, then by column
-            std::ranges::sort(winningCells, [](const auto& a, const auto& b) {
-                return a.row == b.row ? a.col < b.col : a.row < b.row;
-            });
-            
-            return {true, player, std::move(winningCells)};
+    for (const auto& [dRow, dCol] : LINE_DIRECTIONS) {
+        const auto behind = extent(-dRow, -dCol);
+        const auto ahead = extent(dRow, dCol);
+        if (behind + 1 + ahead >= 4) {
+            // Every direction steps down a row or right along one, so walking it yields the cells sorted
+            WinResult result{true, player, {}};
+            for (auto i = -behind; i <= ahead; ++i) {
+                result.winningCells.push_back({static_cast<uint16_t>(rowPlayed + dRow * i),
+                                               static_cast<uint16_t>(colPlayed + dCol * i)});
+            }
+            return result;
         }
     }
 
     return {false, 0, {}};
-}
\ No newline at end of file
+}
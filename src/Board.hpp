@@ -1,6 +1,7 @@
 #ifndef BOARD_HPP
 #define BOARD_HPP
 
+#include <array>
 #include <cstdint>
 #include <utility>
 #include <expected>
@@ -10,6 +11,19 @@
 #include <format>
 #include <print>
 #include <stdexcept>
+#include <string_view>
+
+#include "SmallVector.hpp"
+#include "Zobrist.hpp"
+
+// Boards up to this size keep all their storage inside the Board object, so creating, copying and
+// playing on them never allocates; larger boards use the heap (CMake options of the same names)
+#ifndef CONNECT_FOUR_INLINE_WIDTH
+#define CONNECT_FOUR_INLINE_WIDTH 10
+#endif
+#ifndef CONNECT_FOUR_INLINE_HEIGHT
+#define CONNECT_FOUR_INLINE_HEIGHT 10
+#endif
 
 struct CellPosition {
     uint16_t row;
@@ -19,9 +33,11 @@ struct CellPosition {
 };
 
 struct WinResult {
+    static constexpr std::size_t MAX_CELLS = 7;  // The played piece and up to three on either side
+
     bool hasWon{false};
     uint8_t winner{0};
-    std::vector<CellPosition> winningCells;
+    SmallVector<CellPosition, MAX_CELLS> winningCells;
 
     auto operator<=>(const WinResult&) const = default;
 };
@@ -46,21 +62,54 @@ struct std::formatter<GameResult> : std::formatter<string_view> {
     }
 };
 
+// Why place() rejected a move. As wide as the move so place()'s result comes back in two registers;
+// a one-byte error packs it into one that every caller has to pick apart.
+enum class PlaceError : uint32_t { COLUMN_OUT_OF_BOUNDS, COLUMN_FULL };
+
+template<>
+struct std::formatter<PlaceError> : std::formatter<string_view> {
+    static auto format(const PlaceError error, format_context& ctx) {
+        return format_to(ctx.out(), "{}", error == PlaceError::COLUMN_FULL ? "Column is full" : "Column out of bounds");
+    }
+};
+
+// Cell storage of a Board. BITBOARD keeps one 64-bit mask per player and needs (height + 1) * width <= 64.
+// CELLS keeps a byte per cell plus run caches that make win checks O(1), about 24 bytes per cell in all.
+// PACKED keeps 3 bits per cell in column words and checks wins with SWAR arithmetic, the smallest
+// layout for giant and many-player boards. AUTO picks BITBOARD when the board fits, CELLS otherwise.
+enum class BoardBackend : uint8_t { AUTO, BITBOARD, CELLS, PACKED };
+
+// Fills order with every column index, center first and alternating outwards (left before right)
+constexpr void centerFirstColumnOrder(const std::span<uint16_t> order) noexcept {
+    const int width = static_cast<int>(order.size());
+    for (int i = 0; i < width; ++i) {
+        order[i] = static_cast<uint16_t>(width / 2 + (1 - 2 * (i % 2)) * (i + 1) / 2);
+    }
+}
+
 class Board {
 public:
+    static constexpr uint8_t MAX_PLAYERS = 6;
+    static constexpr std::size_t INLINE_WIDTH = CONNECT_FOUR_INLINE_WIDTH;
+    static constexpr std::size_t INLINE_HEIGHT = CONNECT_FOUR_INLINE_HEIGHT;
+    static constexpr std::size_t INLINE_CELLS = INLINE_WIDTH * INLINE_HEIGHT;
+
     const uint16_t width;
     const uint16_t height;
-    std::vector<uint8_t> board;
-    const uint16_t maxMoves;
-    std::vector<uint8_t> heights;
+    SmallVector<uint8_t, INLINE_CELLS> board;  // Cell storage, only populated by the cell backend
+    const uint32_t maxMoves;
+    const uint64_t bottomMask;  // Lowest cell of every column in the bitboard layout, 0 if the board does not fit one
+    SmallVector<uint16_t, INLINE_WIDTH> heights;
 
-    uint16_t movesPlayed{0};
+    uint32_t movesPlayed{0};
 
     // Constructor with size validation
-    explicit Board(const uint16_t width, const uint16_t height)
+    explicit Board(const uint16_t width, const uint16_t height, const BoardBackend backend = BoardBackend::AUTO)
         : width(width)
         , height(height)
-        , maxMoves(width * height)
+        , maxMoves(static_cast<uint32_t>(width) * height)
+        , bottomMask(fitsBitboard(width, height) ? columnBottoms(width, height) : 0)
+        , backendKind(resolveBackend(width, height, backend))
     {
         if (width == 0 || height == 0) {
             throw std::invalid_argument("Board dimensions must be positive");
@@ -70,7 +119,15 @@ public:
         }
 
         try {
-            board.resize(maxMoves, 0);
+            if (backendKind == BoardBackend::CELLS) {
+                board.resize(maxMoves, 0);
+                runs.resize((static_cast<std::size_t>(width) + 2) * (height + 2));
+                runOwners.resize(runs.size(), 0);
+                placed.reserve(maxMoves);  // Giant boards allocate here once, never while playing
+            } else if (backendKind == BoardBackend::PACKED) {
+                packedWords = (height + PACKED_CELLS - 1) / PACKED_CELLS;
+                packed.resize(static_cast<std::size_t>(width) * packedWords, 0);
+            }
             heights.resize(width, 0);
         } catch (const std::bad_alloc&) {
             throw std::runtime_error("Failed to allocate board memory");
@@ -87,32 +144,115 @@ public:
     Board(const Board& other)
         : width(other.width)
         , height(other.height)
-        , board(other.board)  // vector has a copy constructor
+        , board(other.board)
         , maxMoves(other.maxMoves)
+        , bottomMask(other.bottomMask)
+        , heights(other.heights)
         , movesPlayed(other.movesPlayed)
-        , heights(other.heights)  // vector has a copy constructor
+        , backendKind(other.backendKind)
+        , occupied(other.occupied)
+        , playerMasks(other.playerMasks)
+        , hash(other.hash)
+        , mirrorHash(other.mirrorHash)
+        , runs(other.runs)
+        , runOwners(other.runOwners)
+        , placed(other.placed)
+        , packed(other.packed)
+        , packedWords(other.packedWords)
     {}
 
-    [[nodiscard]] std::expected<std::pair<uint16_t, uint16_t>, std::string>
+    // A column needs height + 1 bits (one sentinel bit on top) so shifts never wrap into the next column
+    [[nodiscard]] static constexpr bool
+    fitsBitboard(const uint16_t width, const uint16_t height) noexcept {
+        return (height + 1) * width <= 64;
+    }
+
+    // Bit of the lowest cell of every column, for a board that fits a bitboard
+    [[nodiscard]] static constexpr uint64_t
+    columnBottoms(const uint16_t width, const uint16_t height) noexcept {
+        uint64_t bottom = 0;
+        for (uint16_t col = 0; col < width; ++col) bottom |= uint64_t{1} << (col * (height + 1));
+        return bottom;
+    }
+
+    // True if the pieces of a bitboard of the given height hold four in a row
+    [[nodiscard]] static bool
+    hasFourInMask(uint64_t mask, uint16_t height) noexcept;
+
+    [[nodiscard]] bool usesBitboard() const noexcept {
+        return backendKind == BoardBackend::BITBOARD;
+    }
+
+    // Backend in use, never AUTO
+    [[nodiscard]] BoardBackend backend() const noexcept {
+        return backendKind;
+    }
+
+    // Zobrist key of the pieces on the board, updated incrementally by place()
+    [[nodiscard]] uint64_t zobristHash() const noexcept {
+        return hash;
+    }
+
+    // Zobrist key of the board's left-right mirror image, maintained alongside (see Symmetry.hpp)
+    [[nodiscard]] uint64_t mirroredZobristHash() const noexcept {
+        return mirrorHash;
+    }
+
+    // Per-player bitboards (index = player - 1), all zero when the bitboard backend is not in use
+    [[nodiscard]] const std::array<uint64_t, MAX_PLAYERS>& bitboardMasks() const noexcept {
+        return playerMasks;
+    }
+
+    // Player occupying the cell (row 0 is the top row), 0 if empty
+    [[nodiscard]] uint8_t cell(const uint16_t row, const uint16_t col) const noexcept {
+        if (backendKind == BoardBackend::CELLS) {
+            return board[row * width + col];
+        }
+        if (backendKind == BoardBackend::PACKED) {
+            const auto rowFromBottom = height - 1 - row;
+            return static_cast<uint8_t>(packedWord(col, rowFromBottom) >> packedShift(rowFromBottom) & 7);
+        }
+        const auto bit = bitAt(row, col);
+        if ((occupied & bit) == 0) return 0;
+        for (uint8_t player = 0; player < MAX_PLAYERS; ++player) {
+            if (playerMasks[player] & bit) return player + 1;
+        }
+        return 0;
+    }
+
+    [[nodiscard]] std::expected<std::pair<uint16_t, uint16_t>, PlaceError>
     place(uint16_t col, uint8_t player) noexcept;
 
     [[nodiscard]] bool
     canPlace(uint16_t col) const noexcept;
 
+    // Removes the top piece of col and returns the player it belonged to (0 if the column is empty).
+    // Taking moves back in reverse order is O(1); any other order walks the runs through the cell.
+    uint8_t undo(uint16_t col) noexcept;
+
+    // True if player dropping a piece into col would connect four; does not modify the board
+    [[nodiscard]] bool
+    isWinningMove(uint16_t col, uint8_t player) const noexcept;
+
+    // Number of columns where player would connect four with their next piece
+    [[nodiscard]] uint16_t
+    countWinningMoves(uint8_t player) const noexcept;
+
     [[nodiscard]] GameResult
     checkWin(std::pair<uint16_t, uint16_t> lastMove) const noexcept;
 
     [[nodiscard]] WinResult
     checkWinDetailed(uint16_t rowPlayed, uint16_t colPlayed) const noexcept;
 
+    // Raw cell storage of the cell backend, empty for the others (see cell())
     [[nodiscard]] std::span<const uint8_t> view() const noexcept {
-        return {board};
+        return {board.data(), board.size()};
     }
 
     void debug_print() const {
         for (uint16_t i = 0; i < height; ++i) {
             for (uint16_t j = 0; j < width; ++j) {
-                std::print("{} ", board[i * width + j]);
+                std::print("{} ", cell(i, j));
             }
             std::println("");
         }
@@ -124,6 +264,88 @@ public:
     }
 
 private:
+    // Bitboard backend: bit (col * (height + 1) + rowFromBottom) is set in the mask of the player owning the cell
+    const BoardBackend backendKind;
+    uint64_t occupied{0};
+    std::array<uint64_t, MAX_PLAYERS> playerMasks{};
+
+    uint64_t hash{0};
+    uint64_t mirrorHash{0};
+
+    // Cell backend: for every piece and line direction, how many pieces of the same player continue
+    // the line behind and ahead of it. Only the two ends of each run are kept exact, which is all a
+    // new piece next to the run needs, so place() and undo() touch only the neighbours and the far ends.
+    // Both grids have an empty border so neighbours are read without bounds checks.
+    struct LineRuns {
+        std::array<uint16_t, 4> behind{};
+        std::array<uint16_t, 4> ahead{};
+    };
+    static constexpr std::size_t INLINE_RUNS = (INLINE_WIDTH + 2) * (INLINE_HEIGHT + 2);
+    SmallVector<LineRuns, INLINE_RUNS> runs;
+    SmallVector<uint8_t, INLINE_RUNS> runOwners;  // Player of each cell of runs, 0 if empty or on the border
+
+    // Pieces placed since the last out-of-order undo, with the longest line each one made. While a piece
+    // is the last one its neighbours still hold the runs it joined, so checkWin() and undo() need no scan.
+    struct PlacedPiece {
+        uint32_t index;
+        uint16_t longestLine;
+    };
+    SmallVector<PlacedPiece, INLINE_CELLS> placed;
+
+    // Packed backend: 3 bits per cell, PACKED_CELLS cells per word from the bottom of each column up and
+    // packedWords words per column. Bit 63 of every word stays clear.
+    static constexpr unsigned PACKED_CELLS = 21;
+    SmallVector<uint64_t, INLINE_WIDTH * ((INLINE_HEIGHT + PACKED_CELLS - 1) / PACKED_CELLS)> packed;
+    uint32_t packedWords{0};
+
+    [[nodiscard]] static BoardBackend resolveBackend(uint16_t width, uint16_t height, BoardBackend backend);
+
+    [[nodiscard]] uint64_t& packedWord(const uint16_t col, const uint32_t rowFromBottom) noexcept {
+        return packed[static_cast<std::size_t>(col) * packedWords + rowFromBottom / PACKED_CELLS];
+    }
+
+    [[nodiscard]] uint64_t packedWord(const uint16_t col, const uint32_t rowFromBottom) const noexcept {
+        return packed[static_cast<std::size_t>(col) * packedWords + rowFromBottom / PACKED_CELLS];
+    }
+
+    [[nodiscard]] static unsigned packedShift(const uint32_t rowFromBottom) noexcept {
+        return 3 * (rowFromBottom % PACKED_CELLS);
+    }
+
+    // Seven cells of col from firstRow (counted from the bottom) up, packed 3 bits each; cells outside
+    // the board read as empty
+    [[nodiscard]] uint64_t packedWindow(int col, int firstRow) const noexcept;
+
+    // True if the piece of player at (col, rowFromBottom) is part of four in a row; with assumePlaced the
+    // cell may still be empty and counts as the player's
+    [[nodiscard]] bool packedLine(uint16_t col, uint32_t rowFromBottom, uint8_t player, bool assumePlaced) const noexcept;
+
+    [[nodiscard]] uint64_t bitAt(const uint16_t row, const uint16_t col) const noexcept {
+        return uint64_t{1} << (col * (height + 1) + (height - 1 - row));
+    }
+
+    [[nodiscard]] GameResult
+    checkWinBitboard(std::pair<uint16_t, uint16_t> lastMove) const noexcept;
+
+    // Number of consecutive player pieces starting next to (row, col) and walking in (dRow, dCol)
+    [[nodiscard]] int
+    countDirection(uint16_t row, uint16_t col, int dRow, int dCol, uint8_t player) const noexcept;
+
+    [[nodiscard]] std::size_t runIndex(const uint16_t row, const uint16_t col) const noexcept {
+        return (static_cast<std::size_t>(row) + 1) * (width + 2) + col + 1;
+    }
+
+    // Pieces of player continuing the line behind and ahead of an empty or just played cell of runs
+    [[nodiscard]] std::pair<int, int>
+    runsAround(std::size_t index, std::size_t direction, uint8_t player) const noexcept;
+
+    // Pieces of player in a row from the cell of runs next to index, walking by step
+    [[nodiscard]] int
+    walkRun(std::size_t index, std::ptrdiff_t step, uint8_t player) const noexcept;
+
+    void updateRuns(uint16_t row, uint16_t col, uint8_t player) noexcept;
+    void removeRuns(uint16_t row, uint16_t col, uint8_t player) noexcept;
+
     [[nodiscard]] static bool
     isValidPosition(const uint16_t row, const uint16_t col, const uint16_t numRows, const uint16_t numCols) noexcept {
         return row < numRows && col < numCols;
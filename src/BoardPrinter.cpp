@@ -22,7 +22,7 @@ std::string BoardPrinter::getColorCode(const int colorIndex) {
 }
 
 void BoardPrinter::printBoard(const Board& boardInstance, 
-                            const std::vector<CellPosition>* win) {
+                            const std::span<const CellPosition> win) {
     std::string str;
     std::string rawStr;
     const int width = boardInstance.width;
@@ -30,15 +30,15 @@ void BoardPrinter::printBoard(const Board& boardInstance,
 
     for (int row = 0; row < height; row++) {
         for (int col = 0; col < width; col++) {
-            const int cellValue = boardInstance.board[row * width + col];
+            const int cellValue = boardInstance.cell(row, col);
             std::string colorCode = getColorCode(cellValue);
 
             rawStr += std::to_string(cellValue).append(" ");
 
-            if (!win) {
+            if (win.empty()) {
                 str += colorCode.append("⬤ ").append(RESET_COLOR);
             } else {
-                bool isWinningCell = std::ranges::any_of(*win,
+                bool isWinningCell = std::ranges::any_of(win,
                      [row, col](const CellPosition& cell) {
                          return cell.row == row && cell.col == col;
                      }
@@ -1,6 +1,6 @@
 #pragma once
 #include <string>
-#include <vector>
+#include <span>
 #include <map>
 #include "Board.hpp"
 
@@ -9,7 +9,7 @@ class Board;  // Forward declaration, assuming Board class exists
 class BoardPrinter {
 public:
     static void printBoard(const Board& boardInstance, 
-                         const std::vector<CellPosition>* win = nullptr);
+                         std::span<const CellPosition> win = {});
 
 private:
     static const std::map<int, std::string> colors;
@@ -0,0 +1,155 @@
+// Offline opening book generator: enumerates every position up to N plies (mirror images folded),
+// solves them on all cores and writes a book that getMove() can memory-map.
+//
+// Usage: ConnectFourBook <output> [--plies N] [--width W] [--height H] [--depth D | --exact] [--threads T]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <print>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+#include "ExactSolver.hpp"
+#include "FixedGame.hpp"
+#include "OpeningBook.hpp"
+#include "Solver.hpp"
+#include "ThreadPool.hpp"
+
+namespace {
+    struct Options {
+        std::string output;
+        uint16_t plies{8};
+        uint16_t width{7};
+        uint16_t height{6};
+        int depth{14};
+        bool exact{false};
+        unsigned threads{std::max(1u, std::thread::hardware_concurrency())};
+    };
+
+    // Depth-first walk keeping the first orientation seen of every undecided position
+    template<typename GameType>
+    void collectPositions(GameType& game, const uint16_t plies, std::unordered_set<uint64_t>& seen,
+                          std::vector<GameType>& positions) {
+        if (!seen.insert(canonicalKey(game).key).second) return;
+        positions.push_back(game);
+        if (game.board.movesPlayed >= plies) return;
+
+        for (uint16_t col = 0; col < game.board.width; ++col) {
+            if (!game.board.canPlace(col)) continue;
+            if (!game.place(col)) {
+                collectPositions(game, plies, seen, positions);
+            }
+            game.unplace(col);
+        }
+    }
+
+    template<typename GameType>
+    int generate(GameType& root, const Options& options) {
+        constexpr bool exactAvailable = std::is_same_v<GameType, ExactSolver::GameType>;
+        if (options.exact && !exactAvailable) {
+            std::println("Exact solving is only available for the 7x6 board");
+            return 1;
+        }
+
+        std::unordered_set<uint64_t> seen;
+        std::vector<GameType> positions;
+        collectPositions(root, options.plies, seen, positions);
+        std::println("Solving {} positions up to {} plies on {} threads", positions.size(), options.plies, options.threads);
+
+        std::vector<std::pair<uint64_t, BookEntry>> entries(positions.size());
+        std::atomic<std::size_t> nextPosition{0};
+        std::atomic<std::size_t> solvedPositions{0};
+        const auto start = std::chrono::steady_clock::now();
+
+        const auto worker = [&] {
+            // Every worker owns its solver, so threads only share the position counter
+            std::unique_ptr<ExactSolver> solver;
+            if (options.exact) solver = std::make_unique<ExactSolver>();
+            Solver<GameType> heuristic(16, 1);
+
+            for (auto index = nextPosition++; index < positions.size(); index = nextPosition++) {
+                const auto& game = positions[index];
+                BookEntry entry{TranspositionTable::NO_MOVE, 0};
+
+                if constexpr (exactAvailable) {
+                    if (solver) {
+                        const auto scores = solver->analyze(game);
+                        for (uint16_t col : GameType::BoardType::columnOrder) {
+                            if (scores[col] && (entry.move == TranspositionTable::NO_MOVE || *scores[col] > entry.score)) {
+                                entry = {col, static_cast<int16_t>(*scores[col])};
+                            }
+                        }
+                    }
+                }
+                if (entry.move == TranspositionTable::NO_MOVE) {
+                    const auto result = heuristic.search(game, {.maxDepth = options.depth});
+                    entry = {result.bestMove, static_cast<int16_t>(std::clamp(result.score, -32767, 32767))};
+                }
+
+                // Store the move in the orientation of the canonical key
+                const auto canonical = canonicalKey(game);
+                entry.move = canonical.orient(entry.move, game.board.width);
+                entries[index] = {canonical.key, entry};
+
+                if (const auto solved = ++solvedPositions; solved % 1000 == 0) {
+                    std::println("{} / {} positions solved", solved, positions.size());
+                }
+            }
+        };
+
+        // The calling thread is the last worker
+        ThreadPool::global().ensureWorkers(options.threads - 1);
+        TaskGroup workers;
+        for (unsigned i = 1; i < options.threads; ++i) {
+            workers.run(worker);
+        }
+        worker();
+        workers.wait();
+
+        const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+        if (const auto written = OpeningBook::write(options.output, root.board.width, root.board.height,
+                                                    options.plies, std::move(entries)); !written) {
+            std::println("{}", written.error());
+            return 1;
+        }
+        std::println("Wrote {} positions to {} in {} seconds", positions.size(), options.output, duration.count());
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            const auto value = [&] {
+                if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + arg);
+                return std::stoi(argv[++i]);
+            };
+            if (arg == "--plies") options.plies = static_cast<uint16_t>(value());
+            else if (arg == "--width") options.width = static_cast<uint16_t>(value());
+            else if (arg == "--height") options.height = static_cast<uint16_t>(value());
+            else if (arg == "--depth") options.depth = value();
+            else if (arg == "--threads") options.threads = static_cast<unsigned>(std::max(1, value()));
+            else if (arg == "--exact") options.exact = true;
+            else if (options.output.empty()) options.output = arg;
+            else throw std::invalid_argument("Unknown argument " + arg);
+        }
+        if (options.output.empty()) {
+            throw std::invalid_argument("Missing output path");
+        }
+
+        const Game game(options.width, options.height, 2);
+        return visitFixedGame(game, [&options](auto& root) {
+            return generate(root, options);
+        });
+    } catch (const std::exception& e) {
+        std::println("{}", e.what());
+        std::println("Usage: ConnectFourBook <output> [--plies N] [--width W] [--height H] [--depth D | --exact] [--threads T]");
+        return 1;
+    }
+}
@@ -0,0 +1,14 @@
+// Headless engine speaking the line protocol described in Protocol.hpp on stdin/stdout, for scripts
+// and orchestration that run many engine processes side by side.
+//
+// Usage: ConnectFourEngine < requests
+
+#include <iostream>
+
+#include "Protocol.hpp"
+
+int main() {
+    // Unsynced input is buffered, which lets the protocol see whether more requests are waiting
+    std::ios::sync_with_stdio(false);
+    return runProtocol(std::cin);
+}
@@ -0,0 +1,223 @@
+#include "ExactSolver.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "Symmetry.hpp"
+
+namespace {
+    using BoardType = ExactSolver::GameType::BoardType;
+    constexpr int H1 = ExactSolver::HEIGHT + 1;
+}
+
+ExactSolver::ExactSolver()
+    : tableKeys(TABLE_SIZE, 0)
+    , tableValues(TABLE_SIZE, 0)
+{}
+
+void ExactSolver::reset() {
+    std::ranges::fill(tableKeys, 0);
+    std::ranges::fill(tableValues, 0);
+}
+
+void ExactSolver::store(const uint64_t key, const uint8_t value) noexcept {
+    const auto index = key % TABLE_SIZE;
+    tableKeys[index] = static_cast<uint32_t>(key);
+    tableValues[index] = value;
+}
+
+uint8_t ExactSolver::lookup(const uint64_t key) const noexcept {
+    const auto index = key % TABLE_SIZE;
+    return tableKeys[index] == static_cast<uint32_t>(key) ? tableValues[index] : 0;
+}
+
+ExactSolver::Position ExactSolver::positionOf(const GameType& game) noexcept {
+    const auto& masks = game.board.bitboardMasks();
+    return {masks[game.currentPlayer - 1], masks[0] | masks[1], game.board.movesPlayed};
+}
+
+ExactSolver::Position ExactSolver::play(const Position& position, const Mask move) noexcept {
+    // The stones of the player who just moved become the opponent's, so current flips to the other side
+    return {position.current ^ position.mask, position.mask | move, position.moves + 1};
+}
+
+ExactSolver::Mask ExactSolver::possible(const Position& position) noexcept {
+    return (position.mask + BoardType::bottomMask) & BoardType::boardMask;
+}
+
+// Empty cells that would complete four in a row for stones
+ExactSolver::Mask ExactSolver::winningCells(const Mask stones, const Mask mask) noexcept {
+    // Vertical
+    Mask cells = (stones << 1) & (stones << 2) & (stones << 3);
+
+    // Horizontal and both diagonals: the empty cell can be at any of the four places of the line
+    for (const int shift : {H1, H1 - 1, H1 + 1}) {
+        Mask pair = (stones << shift) & (stones << 2 * shift);
+        cells |= pair & (stones << 3 * shift);
+        cells |= pair & (stones >> shift);
+        pair = (stones >> shift) & (stones >> 2 * shift);
+        cells |= pair & (stones << shift);
+        cells |= pair & (stones >> 3 * shift);
+    }
+
+    return cells & (BoardType::boardMask ^ mask);
+}
+
+bool ExactSolver::canWinNext(const Position& position) noexcept {
+    return (winningCells(position.current, position.mask) & possible(position)) != 0;
+}
+
+// Moves that do not let the opponent win immediately; when the opponent has two threats there are none
+ExactSolver::Mask ExactSolver::possibleNonLosingMoves(const Position& position) noexcept {
+    auto moves = possible(position);
+    const auto opponentWins = winningCells(position.current ^ position.mask, position.mask);
+    if (const auto forced = moves & opponentWins) {
+        if (forced & (forced - 1)) return 0;
+        moves = forced;
+    }
+    return moves & ~(opponentWins >> 1);  // Never play directly below an opponent threat
+}
+
+int ExactSolver::moveScore(const Position& position, const Mask move) noexcept {
+    return std::popcount(winningCells(position.current | move, position.mask));
+}
+
+int ExactSolver::negamax(const Position& position, int alpha, int beta) {
+    nodeCount++;
+
+    const auto next = possibleNonLosingMoves(position);
+    if (next == 0) {
+        return -(WIDTH * HEIGHT - position.moves) / 2;  // Every move loses to the opponent's reply
+    }
+    if (position.moves >= WIDTH * HEIGHT - 2) {
+        return 0;  // Neither side can win in the last two moves
+    }
+
+    // Lower bound: the opponent cannot win with their next move
+    if (const int min = -(WIDTH * HEIGHT - 2 - position.moves) / 2; alpha < min) {
+        alpha = min;
+        if (alpha >= beta) return alpha;
+    }
+
+    // Upper bound: we cannot win with our next move
+    int max = (WIDTH * HEIGHT - 1 - position.moves) / 2;
+    const auto key = position.key();
+    if (const int value = lookup(key)) {
+        if (value > MAX_SCORE - MIN_SCORE + 1) {
+            if (const int min = value + 2 * MIN_SCORE - MAX_SCORE - 2; alpha < min) {
+                alpha = min;
+                if (alpha >= beta) return alpha;
+            }
+        } else {
+            max = value + MIN_SCORE - 1;
+        }
+    }
+    if (beta > max) {
+        beta = max;
+        if (alpha >= beta) return beta;
+    }
+
+    // Order candidate moves by threats created, ties in center-first order (kept by insertion sort)
+    std::array<std::pair<Mask, int>, WIDTH> moves{};
+    int count = 0;
+    for (const auto col : BoardType::columnOrder) {
+        const auto move = next & BoardType::columnMask(col);
+        if (!move) continue;
+        const auto score = moveScore(position, move);
+        auto pos = count++;
+        while (pos > 0 && moves[pos - 1].second < score) {
+            moves[pos] = moves[pos - 1];
+            --pos;
+        }
+        moves[pos] = {move, score};
+    }
+
+    for (int i = 0; i < count; ++i) {
+        const int score = -negamax(play(position, moves[i].first), -beta, -alpha);
+        if (score >= beta) {
+            store(key, static_cast<uint8_t>(score + MAX_SCORE - 2 * MIN_SCORE + 2));
+            return score;
+        }
+        alpha = std::max(alpha, score);
+    }
+
+    store(key, static_cast<uint8_t>(alpha - MIN_SCORE + 1));
+    return alpha;
+}
+
+int ExactSolver::solveScore(const Position& position) {
+    if (canWinNext(position)) {
+        return (WIDTH * HEIGHT + 1 - position.moves) / 2;
+    }
+
+    int min = -(WIDTH * HEIGHT - position.moves) / 2;
+    int max = (WIDTH * HEIGHT + 1 - position.moves) / 2;
+
+    // Bisect with null windows, probing near zero first since small scores are cheapest to refute
+    while (min < max) {
+        int med = min + (max - min) / 2;
+        if (med <= 0 && min / 2 < med) {
+            med = min / 2;
+        } else if (med >= 0 && max / 2 > med) {
+            med = max / 2;
+        }
+        if (const int score = negamax(position, med, med + 1); score <= med) {
+            max = score;
+        } else {
+            min = score;
+        }
+    }
+    return min;
+}
+
+ExactResult ExactSolver::resultOf(const int score, const int movesPlayed) {
+    ExactResult result;
+    result.score = score;
+    if (score == 0) {
+        result.outcome = ExactResult::Outcome::DRAW;
+        return result;
+    }
+
+    // The winner plays its last stone after `lastMove` moves, which has the winner's parity
+    result.outcome = score > 0 ? ExactResult::Outcome::WIN : ExactResult::Outcome::LOSS;
+    const int winnerParity = (movesPlayed + (score > 0 ? 0 : 1)) % 2;
+    const int lastMove = WIDTH * HEIGHT + winnerParity - 2 * std::abs(score);
+    result.distance = lastMove - movesPlayed + 1;
+    return result;
+}
+
+ExactResult ExactSolver::solve(const GameType& game) {
+    if (game.board.hasWon(1) || game.board.hasWon(2) || game.board.movesPlayed >= GameType::BoardType::maxMoves) {
+        throw std::invalid_argument("Position is already decided");
+    }
+
+    nodeCount = 0;
+    const auto start = std::chrono::steady_clock::now();
+    const auto position = positionOf(game);
+    auto result = resultOf(solveScore(position), position.moves);
+    result.nodes = nodeCount;
+    result.time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    return result;
+}
+
+std::array<std::optional<int>, ExactSolver::WIDTH> ExactSolver::analyze(const GameType& game) {
+    std::array<std::optional<int>, WIDTH> scores{};
+    const auto position = positionOf(game);
+    const bool symmetric = isMirrorSymmetric(game.board);
+    for (uint16_t col = 0; col < WIDTH; ++col) {
+        if (!game.board.canPlace(col)) continue;
+        if (symmetric && isMirroredColumn(col, WIDTH)) {
+            scores[col] = scores[WIDTH - 1 - col];
+            continue;
+        }
+        if (game.isWinningMove(col)) {
+            scores[col] = (WIDTH * HEIGHT + 1 - position.moves) / 2;
+            continue;
+        }
+        const auto move = possible(position) & BoardType::columnMask(col);
+        const auto child = play(position, move);
+        scores[col] = child.moves >= WIDTH * HEIGHT ? 0 : -solveScore(child);
+    }
+    return scores;
+}
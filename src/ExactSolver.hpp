@@ -0,0 +1,100 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "FixedGame.hpp"
+
+// Game-theoretic value of a position for the side to move
+struct ExactResult {
+    enum class Outcome { WIN, LOSS, DRAW };
+
+    Outcome outcome{Outcome::DRAW};
+    // Positive when the side to move wins: one more than the number of its pieces still in hand
+    // when it connects four. Negative for a loss, 0 for a draw.
+    int score{0};
+    // Plies until the game is decided with perfect play from both sides (0 for a draw)
+    int distance{0};
+    unsigned long long nodes{0};
+    std::chrono::microseconds time{0};
+
+    [[nodiscard]] double nodesPerSecond() const noexcept {
+        return time.count() > 0 ? static_cast<double>(nodes) * 1e6 / static_cast<double>(time.count()) : 0.0;
+    }
+};
+
+// Perfect-play solver for the standard 7x6 two-player board.
+// Null-window negamax on bitboards: the score is found by bisecting with (alpha, alpha + 1) windows,
+// moves that hand the opponent an immediate win are never searched, moves are ordered by the number
+// of winning spots they create, and bounds are cached in a compact partial-key transposition table.
+class ExactSolver {
+public:
+    using GameType = FixedGame<7, 6>;
+
+    static constexpr int WIDTH = GameType::width;
+    static constexpr int HEIGHT = GameType::height;
+    static constexpr int MIN_SCORE = -(WIDTH * HEIGHT) / 2 + 3;
+    static constexpr int MAX_SCORE = (WIDTH * HEIGHT + 1) / 2 - 3;
+
+    ExactSolver();
+
+    // Solves the position; the game must not already be decided
+    [[nodiscard]] ExactResult solve(const GameType& game);
+
+    // Exact score of every playable column from the point of view of the side to move
+    [[nodiscard]] std::array<std::optional<int>, WIDTH> analyze(const GameType& game);
+
+    // Drops all cached bounds
+    void reset();
+
+    [[nodiscard]] unsigned long long getNodeCount() const {
+        return nodeCount;
+    }
+
+private:
+    using Mask = GameType::BoardType::Mask;
+
+    // Bitboard pair in the solver's own compact form: current player's stones and all stones
+    struct Position {
+        Mask current;
+        Mask mask;
+        int moves;
+
+        // Shared with the mirror image: the key holds one (HEIGHT + 1)-bit group per column, and
+        // reversing the groups reflects the position
+        [[nodiscard]] uint64_t key() const noexcept {
+            constexpr uint64_t COLUMN_BITS = (uint64_t{1} << (HEIGHT + 1)) - 1;
+            const uint64_t own = current + mask;
+            uint64_t mirror = 0;
+            for (int col = 0; col < WIDTH; ++col) {
+                mirror |= ((own >> (col * (HEIGHT + 1))) & COLUMN_BITS) << ((WIDTH - 1 - col) * (HEIGHT + 1));
+            }
+            return mirror < own ? mirror : own;
+        }
+    };
+
+    // Partial-key table: with a prime size above 2^23, the low 32 key bits plus the slot index
+    // identify the 49-bit position key uniquely (Chinese remainder theorem)
+    static constexpr std::size_t TABLE_SIZE = (1u << 23) + 9;
+    std::vector<uint32_t> tableKeys;
+    std::vector<uint8_t> tableValues;
+
+    unsigned long long nodeCount{0};
+
+    void store(uint64_t key, uint8_t value) noexcept;
+    [[nodiscard]] uint8_t lookup(uint64_t key) const noexcept;
+
+    [[nodiscard]] static Position positionOf(const GameType& game) noexcept;
+    [[nodiscard]] static Position play(const Position& position, Mask move) noexcept;
+    [[nodiscard]] static Mask possible(const Position& position) noexcept;
+    [[nodiscard]] static Mask winningCells(Mask stones, Mask mask) noexcept;
+    [[nodiscard]] static Mask possibleNonLosingMoves(const Position& position) noexcept;
+    [[nodiscard]] static bool canWinNext(const Position& position) noexcept;
+    [[nodiscard]] static int moveScore(const Position& position, Mask move) noexcept;
+
+    int negamax(const Position& position, int alpha, int beta);
+    [[nodiscard]] int solveScore(const Position& position);
+    [[nodiscard]] static ExactResult resultOf(int score, int movesPlayed);
+};
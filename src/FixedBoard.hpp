@@ -0,0 +1,170 @@
+#ifndef FIXED_BOARD_HPP
+#define FIXED_BOARD_HPP
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <expected>
+#include <type_traits>
+#include <utility>
+
+#include "Board.hpp"
+#include "Zobrist.hpp"
+
+// Board with dimensions, player count and connect length fixed at compile time.
+// Always uses a bitboard (one mask per player, column-major with a sentinel bit on top of
+// every column), so index arithmetic and win checks reduce to constant shifts.
+template<uint16_t W, uint16_t H, uint8_t Players = 2, uint8_t K = 4>
+class FixedBoard {
+    static_assert(W > 0 && H > 0, "Board dimensions must be positive");
+    static_assert(Players >= 2 && Players <= Board::MAX_PLAYERS, "Number of players must be between 2 and 6");
+    static_assert(K >= 2, "Connect length must be at least 2");
+    static_assert((H + 1) * W <= 128, "Board too large for a fixed bitboard, use Board instead");
+
+public:
+    using Mask = std::conditional_t<(H + 1) * W <= 64, uint64_t, unsigned __int128>;
+
+    static constexpr uint16_t width = W;
+    static constexpr uint16_t height = H;
+    static constexpr uint16_t maxMoves = W * H;
+    static constexpr uint8_t numberOfPlayers = Players;
+    static constexpr uint8_t connectLength = K;
+
+    static constexpr std::array<uint16_t, W> columnOrder = [] {
+        std::array<uint16_t, W> order{};
+        centerFirstColumnOrder(order);
+        return order;
+    }();
+
+    // Lowest cell of every column
+    static constexpr Mask bottomMask = [] {
+        Mask mask{0};
+        for (uint16_t col = 0; col < W; ++col) mask |= Mask{1} << (col * (H + 1));
+        return mask;
+    }();
+
+    // Every playable cell (excludes the sentinel row)
+    static constexpr Mask boardMask = bottomMask * ((Mask{1} << H) - 1);
+
+    // Bit shifts between neighbouring cells: vertical, horizontal, diagonal ↗, diagonal ↘
+    static constexpr std::array<unsigned, 4> directions = {1, H + 1, H + 2, H};
+
+    // Zobrist keys per (cell, player), identical to the ones Board computes on the fly
+    static constexpr std::array<uint64_t, W * H * Players> pieceKeys = [] {
+        std::array<uint64_t, W * H * Players> keys{};
+        for (uint32_t cellIndex = 0; cellIndex < W * H; ++cellIndex) {
+            for (uint8_t player = 1; player <= Players; ++player) {
+                keys[cellIndex * Players + player - 1] = zobrist::pieceKey(cellIndex, player);
+            }
+        }
+        return keys;
+    }();
+
+    std::array<uint8_t, W> heights{};
+    uint16_t movesPlayed{0};
+
+    [[nodiscard]] static constexpr Mask columnMask(const uint16_t col) noexcept {
+        return ((Mask{1} << H) - 1) << (col * (H + 1));
+    }
+
+    [[nodiscard]] std::expected<std::pair<uint16_t, uint16_t>, PlaceError>
+    place(const uint16_t col, const uint8_t player) noexcept {
+        if (col >= W) {
+            return std::unexpected(PlaceError::COLUMN_OUT_OF_BOUNDS);
+        }
+
+        const auto columnHeight = heights[col];
+        if (columnHeight >= H) {
+            return std::unexpected(PlaceError::COLUMN_FULL);
+        }
+
+        const auto bit = Mask{1} << (col * (H + 1) + columnHeight);
+        playerMasks[player - 1] |= bit;
+        occupied |= bit;
+        heights[col] = columnHeight + 1;
+        hash ^= pieceKeys[(col * H + columnHeight) * Players + player - 1];
+        mirrorHash ^= pieceKeys[((W - 1 - col) * H + columnHeight) * Players + player - 1];
+        movesPlayed++;
+        return std::pair<uint16_t, uint16_t>(H - 1 - columnHeight, col);
+    }
+
+    [[nodiscard]] bool canPlace(const uint16_t col) const noexcept {
+        return heights[col] < H;
+    }
+
+    // Removes the top piece of col and returns the player it belonged to (0 if the column is empty)
+    uint8_t undo(const uint16_t col) noexcept {
+        const auto columnHeight = heights[col];
+        if (columnHeight == 0) return 0;
+
+        const auto bit = Mask{1} << (col * (H + 1) + columnHeight - 1);
+        uint8_t player = 0;
+        while ((playerMasks[player] & bit) == 0) ++player;
+
+        playerMasks[player] &= ~bit;
+        occupied &= ~bit;
+        heights[col] = columnHeight - 1;
+        hash ^= pieceKeys[(col * H + columnHeight - 1) * Players + player];
+        mirrorHash ^= pieceKeys[((W - 1 - col) * H + columnHeight - 1) * Players + player];
+        movesPlayed--;
+        return player + 1;
+    }
+
+    // True if player dropping a piece into col would connect K; does not modify the board
+    [[nodiscard]] bool isWinningMove(const uint16_t col, const uint8_t player) const noexcept {
+        return canPlace(col) && hasLine(playerMasks[player - 1] | ((occupied + bottomMask) & columnMask(col)));
+    }
+
+    // True if the player has K in a row anywhere on the board
+    [[nodiscard]] bool hasWon(const uint8_t player) const noexcept {
+        return hasLine(playerMasks[player - 1]);
+    }
+
+    [[nodiscard]] static constexpr bool hasLine(const Mask mask) noexcept {
+        for (const auto shift : directions) {
+            auto line = mask;
+            for (unsigned k = 1; k < K; ++k) {
+                line &= mask >> (k * shift);
+            }
+            if (line) return true;
+        }
+        return false;
+    }
+
+    [[nodiscard]] GameResult checkWin(const std::pair<uint16_t, uint16_t> lastMove) const noexcept {
+        if (const auto player = cell(lastMove.first, lastMove.second); player != 0 && hasWon(player)) {
+            return {true, false, player};
+        }
+        return {false, movesPlayed == maxMoves, std::nullopt};
+    }
+
+    // Player occupying the cell (row 0 is the top row), 0 if empty
+    [[nodiscard]] uint8_t cell(const uint16_t row, const uint16_t col) const noexcept {
+        const auto bit = Mask{1} << (col * (H + 1) + (H - 1 - row));
+        if ((occupied & bit) == 0) return 0;
+        for (uint8_t player = 0; player < Players; ++player) {
+            if (playerMasks[player] & bit) return player + 1;
+        }
+        return 0;
+    }
+
+    [[nodiscard]] const std::array<Mask, Players>& bitboardMasks() const noexcept {
+        return playerMasks;
+    }
+
+    [[nodiscard]] uint64_t zobristHash() const noexcept {
+        return hash;
+    }
+
+    [[nodiscard]] uint64_t mirroredZobristHash() const noexcept {
+        return mirrorHash;
+    }
+
+private:
+    Mask occupied{0};
+    std::array<Mask, Players> playerMasks{};
+    uint64_t hash{0};
+    uint64_t mirrorHash{0};
+};
+
+#endif // FIXED_BOARD_HPP
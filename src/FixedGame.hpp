@@ -0,0 +1,98 @@
+#ifndef FIXED_GAME_HPP
+#define FIXED_GAME_HPP
+
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+
+#include "FixedBoard.hpp"
+#include "Game.hpp"
+
+// Compile-time specialized counterpart of Game, exposing the same members and place() semantics
+template<uint16_t W, uint16_t H, uint8_t Players = 2, uint8_t K = 4>
+class FixedGame {
+public:
+    using BoardType = FixedBoard<W, H, Players, K>;
+
+    static constexpr uint8_t numberOfPlayers = Players;
+    static constexpr uint16_t width = W;
+    static constexpr uint16_t height = H;
+
+    BoardType board;
+    uint8_t currentPlayer{1};
+
+    FixedGame() = default;
+
+    // Converts a runtime Game with matching dimensions and player count
+    explicit FixedGame(const Game& game)
+        : currentPlayer(game.currentPlayer)
+    {
+        if (game.width != W || game.height != H || game.numberOfPlayers != Players) {
+            throw std::invalid_argument("Game does not match the fixed board dimensions");
+        }
+
+        // Replay every column bottom-up so heights, masks and move count stay consistent
+        for (uint16_t col = 0; col < W; ++col) {
+            for (uint16_t row = H; row-- > H - game.board.heights[col];) {
+                (void)board.place(col, game.board.cell(row, col));
+            }
+        }
+    }
+
+    [[nodiscard]] std::optional<MoveResult> place(const uint16_t col) noexcept {
+        const auto moveResult = board.place(col, currentPlayer);
+        if (!moveResult) {
+            return std::nullopt;
+        }
+
+        if (board.hasWon(currentPlayer)) {
+            return MoveResult{*moveResult, {true, false, currentPlayer}};
+        }
+        if (board.movesPlayed == BoardType::maxMoves) {
+            return MoveResult{*moveResult, {false, true, std::nullopt}};
+        }
+
+        currentPlayer = (currentPlayer % numberOfPlayers) + 1;
+        return std::nullopt;
+    }
+
+    // Takes back the top piece of col and gives the move back to the player who made it
+    void unplace(const uint16_t col) noexcept {
+        if (const auto player = board.undo(col); player != 0) {
+            currentPlayer = player;
+        }
+    }
+
+    [[nodiscard]] bool isWinningMove(const uint16_t col) const noexcept {
+        return board.isWinningMove(col, currentPlayer);
+    }
+};
+
+// Runtime factory: calls visitor with a FixedGame copy of game when its size is one of the
+// specialized instantiations, otherwise with a plain Game copy
+template<typename Visitor>
+decltype(auto) visitFixedGame(const Game& game, Visitor&& visitor) {
+    if (game.numberOfPlayers == 2) {
+        if (game.width == 7 && game.height == 6) {
+            FixedGame<7, 6> fixedGame(game);
+            return visitor(fixedGame);
+        }
+        if (game.width == 8 && game.height == 7) {
+            FixedGame<8, 7> fixedGame(game);
+            return visitor(fixedGame);
+        }
+        if (game.width == 9 && game.height == 7) {
+            FixedGame<9, 7> fixedGame(game);
+            return visitor(fixedGame);
+        }
+        if (game.width == 6 && game.height == 5) {
+            FixedGame<6, 5> fixedGame(game);
+            return visitor(fixedGame);
+        }
+    }
+
+    Game dynamicGame(game);
+    return visitor(dynamicGame);
+}
+
+#endif // FIXED_GAME_HPP
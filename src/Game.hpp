@@ -4,6 +4,7 @@
 #include "Board.hpp"
 #include <cstdint>
 #include <optional>
+#include <vector>
 
 struct MoveResult {
     std::pair<uint16_t, uint16_t> move;
@@ -18,9 +19,14 @@ public:
     const uint16_t height;
     uint8_t currentPlayer;
 
+    // When set, place() appends every column played and unplace() takes it back (see
+    // GameRecordWriter::attach); copies start without one, so searches never log
+    std::vector<uint16_t>* moveLog{nullptr};
+
     // Constructor with parameter validation
-    explicit Game(const uint16_t width, const uint16_t height, const uint8_t numberOfPlayers)
-        : board(width, height)
+    explicit Game(const uint16_t width, const uint16_t height, const uint8_t numberOfPlayers,
+                  const BoardBackend backend = BoardBackend::AUTO)
+        : board(width, height, backend)
         , numberOfPlayers(numberOfPlayers)
         , width(width)
         , height(height)
@@ -51,6 +57,9 @@ public:
         if (!moveResult) {
             return std::nullopt;
         }
+        if (moveLog) {
+            moveLog->push_back(col);
+        }
 
         if (const auto gameResult = board.checkWin(*moveResult); gameResult.win || gameResult.draw) {
             return MoveResult{*moveResult, gameResult};
@@ -59,6 +68,21 @@ public:
         currentPlayer = (currentPlayer % numberOfPlayers) + 1;
         return std::nullopt;
     }
+
+    // Takes back the top piece of col and gives the move back to the player who made it
+    void unplace(const uint16_t col) noexcept {
+        if (const auto player = board.undo(col); player != 0) {
+            currentPlayer = player;
+            if (moveLog && !moveLog->empty()) {
+                moveLog->pop_back();
+            }
+        }
+    }
+
+    // True if the current player would win by playing col; does not modify the game
+    [[nodiscard]] bool isWinningMove(const uint16_t col) const noexcept {
+        return board.isWinningMove(col, currentPlayer);
+    }
 };
 
 #endif // GAME_HPP
\ No newline at end of file
@@ -0,0 +1,304 @@
+#include "GameRecord.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <format>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ThreadPool.hpp"
+
+namespace {
+    void appendVarint(std::string& buffer, uint64_t value) {
+        while (value >= 0x80) {
+            buffer.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back(static_cast<char>(value));
+    }
+
+    [[nodiscard]] std::size_t packedSize(const uint64_t moveCount, const unsigned bitsPerMove) noexcept {
+        return static_cast<std::size_t>((moveCount * bitsPerMove + 7) / 8);
+    }
+
+    void decodeMoves(const std::byte* packed, const uint64_t moveCount, const unsigned bitsPerMove,
+                     std::vector<uint16_t>& moves) {
+        moves.resize(moveCount);
+        const uint64_t mask = (uint64_t{1} << bitsPerMove) - 1;
+        uint64_t bits = 0;
+        unsigned available = 0;
+        for (auto& move : moves) {
+            while (available < bitsPerMove) {
+                bits |= static_cast<uint64_t>(*packed++) << available;
+                available += 8;
+            }
+            move = static_cast<uint16_t>(bits & mask);
+            bits >>= bitsPerMove;
+            available -= bitsPerMove;
+        }
+    }
+
+    // Plays one game on an empty board and leaves the board empty again; false on any disagreement
+    [[nodiscard]] bool replayGame(Board& board, const std::span<const uint16_t> moves, const uint8_t outcome,
+                                  const uint8_t players) {
+        bool consistent = outcome == gamerecord::UNFINISHED;
+        std::size_t played = 0;
+        uint8_t player = 1;
+        for (; played < moves.size(); ++played) {
+            const auto col = moves[played];
+            if (col >= board.width || !board.canPlace(col)) {
+                consistent = false;
+                break;
+            }
+            const auto position = board.place(col, player);
+            const auto result = board.checkWin(*position);
+            if (result.win || result.draw) {
+                ++played;
+                consistent = played == moves.size() && outcome == (result.win ? player : gamerecord::DRAW);
+                break;
+            }
+            player = static_cast<uint8_t>(player % players + 1);
+        }
+
+        while (played > 0) {
+            board.undo(moves[--played]);
+        }
+        return consistent;
+    }
+}
+
+uint8_t gamerecord::bitsPerMove(const uint16_t width) noexcept {
+    return static_cast<uint8_t>(std::max(1u, static_cast<unsigned>(std::bit_width(static_cast<unsigned>(width - 1)))));
+}
+
+uint8_t gamerecord::outcomeOf(const Game& game, const std::optional<MoveResult>& lastResult) noexcept {
+    if (!lastResult) return UNFINISHED;
+    if (lastResult->result.win) return lastResult->result.winner.value_or(game.currentPlayer);
+    return lastResult->result.draw ? DRAW : UNFINISHED;
+}
+
+GameRecordWriter::~GameRecordWriter() {
+    (void)close();
+}
+
+std::expected<void, std::string> GameRecordWriter::open(const std::string& filePath, const uint16_t width,
+                                                        const uint16_t height, const uint8_t players) {
+    if (const auto closed = close(); !closed) {
+        return closed;
+    }
+
+    out.open(filePath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return std::unexpected("Cannot create game record " + filePath);
+    }
+    path = filePath;
+    header = {};
+    std::memcpy(header.magic, gamerecord::MAGIC, sizeof(gamerecord::MAGIC));
+    header.width = width;
+    header.height = height;
+    header.players = players;
+    header.bitsPerMove = gamerecord::bitsPerMove(width);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));  // Counts are filled in by close()
+    buffer.reserve(FLUSH_SIZE + 1024);
+    return {};
+}
+
+std::expected<void, std::string> GameRecordWriter::close() {
+    if (!out.is_open()) {
+        return {};
+    }
+    flush();
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.close();
+    if (out.fail()) {
+        return std::unexpected("Failed to write game record " + path);
+    }
+    return {};
+}
+
+void GameRecordWriter::attach(Game& game) noexcept {
+    moves.clear();
+    game.moveLog = &moves;
+}
+
+void GameRecordWriter::detach(Game& game) noexcept {
+    if (game.moveLog == &moves) {
+        game.moveLog = nullptr;
+    }
+}
+
+void GameRecordWriter::finishGame(const Game& game, const std::optional<MoveResult>& lastResult) {
+    write(moves, gamerecord::outcomeOf(game, lastResult));
+    moves.clear();
+}
+
+void GameRecordWriter::write(const std::span<const uint16_t> gameMoves, const uint8_t outcome) {
+    appendVarint(buffer, gameMoves.size());
+    buffer.push_back(static_cast<char>(outcome));
+
+    const unsigned bitsPerMove = header.bitsPerMove;
+    uint64_t bits = 0;
+    unsigned filled = 0;
+    for (const auto col : gameMoves) {
+        bits |= static_cast<uint64_t>(col) << filled;
+        filled += bitsPerMove;
+        while (filled >= 8) {
+            buffer.push_back(static_cast<char>(bits));
+            bits >>= 8;
+            filled -= 8;
+        }
+    }
+    if (filled > 0) {
+        buffer.push_back(static_cast<char>(bits));
+    }
+
+    header.gameCount++;
+    header.moveCount += gameMoves.size();
+    if (buffer.size() >= FLUSH_SIZE) {
+        flush();
+    }
+}
+
+void GameRecordWriter::flush() {
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    buffer.clear();
+}
+
+GameRecordReader::~GameRecordReader() {
+    close();
+}
+
+std::expected<void, std::string> GameRecordReader::open(const std::string& path) {
+    close();
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return std::unexpected("Cannot open game record " + path);
+    }
+
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(gamerecord::Header)) {
+        ::close(fd);
+        return std::unexpected("Game record is truncated");
+    }
+
+    const auto fileSize = static_cast<std::size_t>(info.st_size);
+    void* file = ::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping stays valid after the descriptor is closed
+    if (file == MAP_FAILED) {
+        return std::unexpected("Failed to map game record");
+    }
+
+    const auto* fileHeader = static_cast<const gamerecord::Header*>(file);
+    if (std::memcmp(fileHeader->magic, gamerecord::MAGIC, sizeof(gamerecord::MAGIC)) != 0 ||
+        fileHeader->players < 2 || fileHeader->players > Board::MAX_PLAYERS ||
+        fileHeader->bitsPerMove != gamerecord::bitsPerMove(fileHeader->width)) {
+        ::munmap(file, fileSize);
+        return std::unexpected("Not a valid game record");
+    }
+
+    ::madvise(file, fileSize, MADV_SEQUENTIAL);
+    mapping = file;
+    mappingSize = fileSize;
+    header = fileHeader;
+    data = static_cast<const std::byte*>(file) + sizeof(gamerecord::Header);
+    end = static_cast<const std::byte*>(file) + fileSize;
+    return {};
+}
+
+void GameRecordReader::close() noexcept {
+    if (mapping) {
+        ::munmap(mapping, mappingSize);
+    }
+    mapping = nullptr;
+    mappingSize = 0;
+    header = nullptr;
+    data = nullptr;
+    end = nullptr;
+}
+
+const std::byte* GameRecordReader::parseRecord(const std::byte* position, uint64_t& moveCount,
+                                               uint8_t& outcome) const noexcept {
+    moveCount = 0;
+    for (unsigned shift = 0;; shift += 7) {
+        if (position == end || shift > 63) return nullptr;
+        const auto byte = static_cast<uint8_t>(*position++);
+        moveCount |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) break;
+    }
+    if (position == end || moveCount > static_cast<uint64_t>(header->width) * header->height) return nullptr;
+    outcome = static_cast<uint8_t>(*position++);
+    if (static_cast<std::size_t>(end - position) < packedSize(moveCount, header->bitsPerMove)) return nullptr;
+    return position;
+}
+
+bool GameRecordReader::Cursor::next(std::vector<uint16_t>& moves, uint8_t& outcome) {
+    uint64_t moveCount;
+    const auto* packed = position < reader->end ? reader->parseRecord(position, moveCount, outcome) : nullptr;
+    if (!packed) return false;
+    decodeMoves(packed, moveCount, reader->header->bitsPerMove, moves);
+    position = packed + packedSize(moveCount, reader->header->bitsPerMove);
+    return true;
+}
+
+GameRecordReader::Cursor GameRecordReader::games() const noexcept {
+    return {*this, data};
+}
+
+std::expected<GameRecordReader::ReplayStats, std::string> GameRecordReader::replay() const {
+    if (!isOpen()) {
+        return std::unexpected("No game record is open");
+    }
+
+    // One sequential pass over the record headers finds where every block of games starts
+    std::vector<const std::byte*> blocks;
+    uint64_t games = 0;
+    for (const auto* position = data; position < end; ++games) {
+        if (games % GAMES_PER_BLOCK == 0) blocks.push_back(position);
+        uint64_t moveCount;
+        uint8_t outcome;
+        const auto* packed = parseRecord(position, moveCount, outcome);
+        if (!packed) {
+            return std::unexpected(std::format("Game record is corrupt at game {}", games));
+        }
+        position = packed + packedSize(moveCount, header->bitsPerMove);
+    }
+    if (games != header->gameCount) {
+        return std::unexpected(std::format("Game record holds {} games but its header says {}", games,
+                                           header->gameCount));
+    }
+
+    std::atomic<uint64_t> moves{0};
+    std::atomic<uint64_t> mismatches{0};
+    std::atomic<uint64_t> firstMismatch{games};
+    parallelFor(0, blocks.size(), [&](const std::size_t block) {
+        Board board(header->width, header->height);
+        std::vector<uint16_t> gameMoves;
+        uint8_t outcome;
+        Cursor cursor(*this, blocks[block]);
+        const auto firstGame = block * GAMES_PER_BLOCK;
+        const auto lastGame = std::min<uint64_t>(firstGame + GAMES_PER_BLOCK, games);
+        uint64_t blockMoves = 0;
+        uint64_t blockMismatches = 0;
+        for (auto game = firstGame; game < lastGame && cursor.next(gameMoves, outcome); ++game) {
+            blockMoves += gameMoves.size();
+            if (!replayGame(board, gameMoves, outcome, header->players)) {
+                if (blockMismatches++ == 0) {
+                    auto seen = firstMismatch.load(std::memory_order_relaxed);
+                    while (game < seen && !firstMismatch.compare_exchange_weak(seen, game, std::memory_order_relaxed)) {}
+                }
+            }
+        }
+        moves.fetch_add(blockMoves, std::memory_order_relaxed);
+        mismatches.fetch_add(blockMismatches, std::memory_order_relaxed);
+    });
+
+    ReplayStats stats{games, moves.load(), mismatches.load(), std::nullopt};
+    if (stats.mismatches > 0) stats.firstMismatch = firstMismatch.load();
+    return stats;
+}
@@ -0,0 +1,144 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Game.hpp"
+
+// Compact game-record files.
+// File layout: Header, then one record per game: the move count as a LEB128 varint, an outcome byte
+// and the columns packed LSB-first at bitsPerMove = bit_width(width - 1) bits each (3 bits on 7 and 8
+// wide boards), padded to a byte. A 7x6 game of 30 moves takes 14 bytes instead of a printed board.
+namespace gamerecord {
+    inline constexpr char MAGIC[8] = {'C', '4', 'G', 'A', 'M', 'E', '1', '\0'};
+
+    // Outcome byte: winner 1..MAX_PLAYERS, or one of these
+    inline constexpr uint8_t UNFINISHED = 0;
+    inline constexpr uint8_t DRAW = 0xFF;
+
+    struct Header {
+        char magic[8];
+        uint16_t width;
+        uint16_t height;
+        uint8_t players;
+        uint8_t bitsPerMove;
+        uint16_t reserved;
+        uint64_t gameCount;
+        uint64_t moveCount;
+    };
+    static_assert(sizeof(Header) == 32);
+
+    [[nodiscard]] uint8_t bitsPerMove(uint16_t width) noexcept;
+
+    // Outcome of a game given the result of its last place() call
+    [[nodiscard]] uint8_t outcomeOf(const Game& game, const std::optional<MoveResult>& lastResult) noexcept;
+}
+
+// Appends games to a record file, buffering output in large blocks. attach() hooks a Game so its
+// place() and unplace() calls log the moves; finishGame() then stores them as one record.
+class GameRecordWriter {
+public:
+    GameRecordWriter() = default;
+    ~GameRecordWriter();
+
+    GameRecordWriter(const GameRecordWriter&) = delete;
+    GameRecordWriter& operator=(const GameRecordWriter&) = delete;
+
+    [[nodiscard]] std::expected<void, std::string> open(const std::string& path, uint16_t width, uint16_t height,
+                                                        uint8_t players);
+
+    // Flushes and writes the final counts into the header
+    std::expected<void, std::string> close();
+
+    void attach(Game& game) noexcept;
+    void detach(Game& game) noexcept;
+
+    // Stores the moves logged from the attached game and starts an empty log for the next game
+    void finishGame(const Game& game, const std::optional<MoveResult>& lastResult);
+
+    // Stores a game played elsewhere
+    void write(std::span<const uint16_t> moves, uint8_t outcome);
+
+    [[nodiscard]] uint64_t gameCount() const noexcept {
+        return header.gameCount;
+    }
+
+private:
+    static constexpr std::size_t FLUSH_SIZE = 1 << 20;
+
+    std::ofstream out;
+    std::string path;
+    gamerecord::Header header{};
+    std::string buffer;
+    std::vector<uint16_t> moves;  // Log of the attached game
+
+    void flush();
+};
+
+// Read-only record file memory-mapped straight from disk; games are decoded in place.
+class GameRecordReader {
+public:
+    struct ReplayStats {
+        uint64_t games{0};
+        uint64_t moves{0};
+        uint64_t mismatches{0};  // Games whose recorded outcome differs from what checkWin() reports
+        std::optional<uint64_t> firstMismatch;  // Index of the first such game
+    };
+
+    GameRecordReader() = default;
+    ~GameRecordReader();
+
+    GameRecordReader(const GameRecordReader&) = delete;
+    GameRecordReader& operator=(const GameRecordReader&) = delete;
+
+    [[nodiscard]] std::expected<void, std::string> open(const std::string& path);
+    void close() noexcept;
+
+    [[nodiscard]] bool isOpen() const noexcept {
+        return header != nullptr;
+    }
+
+    [[nodiscard]] const gamerecord::Header& info() const noexcept {
+        return *header;
+    }
+
+    // Walks the games in file order; next() decodes one into moves and returns false after the last
+    class Cursor {
+    public:
+        bool next(std::vector<uint16_t>& moves, uint8_t& outcome);
+
+    private:
+        friend class GameRecordReader;
+        Cursor(const GameRecordReader& reader, const std::byte* position) noexcept
+            : reader(&reader)
+            , position(position)
+        {}
+
+        const GameRecordReader* reader;
+        const std::byte* position;
+    };
+
+    [[nodiscard]] Cursor games() const noexcept;
+
+    // Plays every game through a Board, checking that no game ends early and that checkWin() agrees
+    // with the recorded outcome of the last move. Blocks of games are replayed in parallel.
+    [[nodiscard]] std::expected<ReplayStats, std::string> replay() const;
+
+private:
+    static constexpr uint64_t GAMES_PER_BLOCK = 4096;
+
+    const gamerecord::Header* header{nullptr};
+    const std::byte* data{nullptr};  // First record
+    const std::byte* end{nullptr};
+    void* mapping{nullptr};
+    std::size_t mappingSize{0};
+
+    // Splits a record at position into its move count, outcome and packed moves; nullptr when truncated
+    [[nodiscard]] const std::byte* parseRecord(const std::byte* position, uint64_t& moveCount,
+                                               uint8_t& outcome) const noexcept;
+};
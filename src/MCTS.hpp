@@ -0,0 +1,316 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "Board.hpp"
+#include "Game.hpp"
+#include "Solver.hpp"
+#include "ThreadPool.hpp"
+#include "TranspositionTable.hpp"
+#include "Zobrist.hpp"
+
+struct MctsResult {
+    uint16_t bestMove{TranspositionTable::NO_MOVE};
+    unsigned long long playouts{0};  // Summed over all threads
+    std::chrono::microseconds time{0};
+    std::vector<uint32_t> visits;    // Root visits per column, summed over all threads
+    std::vector<double> rewards;     // Expected reward of every player (index player - 1) after bestMove
+
+    [[nodiscard]] double playoutsPerSecond() const noexcept {
+        return time.count() > 0 ? static_cast<double>(playouts) * 1e6 / static_cast<double>(time.count()) : 0.0;
+    }
+};
+
+// Monte Carlo tree search for any number of players, instantiated for Game and FixedGame.
+// Every playout ends in a reward vector (1 for the winner, 1/players each on a draw) and a node's
+// children are ranked by UCT on the reward of the player choosing between them, so no player is
+// assumed to be anyone's sole opponent. Threads use root parallelism: each grows its own tree in a
+// preallocated node arena and the root visit counts are summed when the budget is spent.
+template<typename GameType>
+class MCTS {
+private:
+    static constexpr uint8_t ONGOING = 0xFF;
+    static constexpr uint8_t DRAW = 0;
+    static constexpr double EXPLORATION = 1.4;
+    static constexpr unsigned long long CHECK_INTERVAL = 64;        // Playouts between budget checks
+    static constexpr unsigned long long DEFAULT_PLAYOUTS = 100000;  // Budget when no limit is given
+
+    using Clock = std::chrono::steady_clock;
+    using Reward = std::array<double, Board::MAX_PLAYERS>;
+
+    struct Node {
+        uint32_t firstChild{0};  // Children are stored contiguously in the arena
+        uint16_t childCount{0};
+        uint16_t move{TranspositionTable::NO_MOVE};
+        uint8_t mover{0};        // Player who played move
+        uint8_t outcome{ONGOING};  // Winner, DRAW, or ONGOING when move did not end the game
+        bool expanded{false};
+        uint32_t visits{0};
+        Reward rewards{};        // Summed playout rewards per player
+    };
+
+    // Tree and buffers owned by one thread, kept between searches so the arena is allocated once
+    struct alignas(64) SearchTree {
+        std::vector<Node> nodes;
+        std::vector<uint32_t> path;
+        std::vector<uint16_t> moves;
+        std::optional<GameType> game;
+        uint64_t random{1};
+        unsigned long long playouts{0};
+    };
+
+    unsigned threadCount;
+    std::size_t memoryBytes;
+    std::size_t nodesPerThread{0};
+    std::vector<std::unique_ptr<SearchTree>> trees;
+    std::atomic<bool> stopSearch{false};
+    std::atomic<unsigned long long> sharedPlayouts{0};
+    SearchLimits activeLimits;
+    Clock::time_point searchStart;
+    uint64_t searchCount{0};
+
+    [[nodiscard]] bool stopped() const noexcept {
+        return stopSearch.load(std::memory_order_relaxed);
+    }
+
+    void checkLimits(const unsigned long long playouts) noexcept {
+        const auto total = sharedPlayouts.fetch_add(playouts, std::memory_order_relaxed) + playouts;
+        const auto budget = activeLimits.nodes != 0 || activeLimits.time.count() != 0 ? activeLimits.nodes
+                                                                                       : DEFAULT_PLAYOUTS;
+        if ((budget != 0 && total >= budget) ||
+            (activeLimits.time.count() != 0 && Clock::now() - searchStart >= activeLimits.time)) {
+            stopSearch.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]] static uint64_t nextRandom(uint64_t& state) noexcept {
+        // xorshift64*
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545F4914F6CDD1DULL;
+    }
+
+    [[nodiscard]] static Reward terminalReward(const uint8_t outcome, const uint8_t players) noexcept {
+        Reward reward{};
+        if (outcome == DRAW) {
+            std::fill_n(reward.begin(), players, 1.0 / players);
+        } else {
+            reward[outcome - 1] = 1.0;
+        }
+        return reward;
+    }
+
+    // UCT over the children, each scored by the reward of the player who moves into it
+    [[nodiscard]] static uint32_t selectChild(const SearchTree& tree, const Node& node) noexcept {
+        const double logVisits = std::log(static_cast<double>(node.visits));
+        uint32_t best = node.firstChild;
+        double bestValue = -1.0;
+        for (uint32_t i = node.firstChild; i < node.firstChild + node.childCount; ++i) {
+            const Node& child = tree.nodes[i];
+            if (child.visits == 0) return i;
+            const auto visits = static_cast<double>(child.visits);
+            const double value = child.rewards[child.mover - 1] / visits + EXPLORATION * std::sqrt(logVisits / visits);
+            if (value > bestValue) {
+                bestValue = value;
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    // Adds a child per legal column, recording which children end the game; false when the arena is full
+    bool expand(SearchTree& tree, const uint32_t index) {
+        auto& game = *tree.game;
+        if (tree.nodes.size() + game.board.width > nodesPerThread) return false;
+
+        const auto firstChild = static_cast<uint32_t>(tree.nodes.size());
+        for (uint16_t col = 0; col < game.board.width; ++col) {
+            if (!game.board.canPlace(col)) continue;
+            Node child;
+            child.move = col;
+            child.mover = game.currentPlayer;
+            if (const auto result = game.place(col)) {
+                child.outcome = result->result.win ? child.mover : DRAW;
+            }
+            game.unplace(col);
+            tree.nodes.push_back(child);
+        }
+
+        Node& node = tree.nodes[index];
+        node.firstChild = firstChild;
+        node.childCount = static_cast<uint16_t>(tree.nodes.size() - firstChild);
+        node.expanded = true;
+        return true;
+    }
+
+    // Plays uniformly random legal moves until the game ends
+    [[nodiscard]] static Reward rollout(SearchTree& tree) {
+        auto& game = *tree.game;
+        while (true) {
+            uint16_t col;
+            do {
+                col = static_cast<uint16_t>((nextRandom(tree.random) >> 32) * game.board.width >> 32);
+            } while (!game.board.canPlace(col));
+
+            const auto mover = game.currentPlayer;
+            const auto result = game.place(col);
+            tree.moves.push_back(col);
+            if (result) {
+                return terminalReward(result->result.win ? mover : DRAW, game.numberOfPlayers);
+            }
+        }
+    }
+
+    // One selection, expansion, simulation and backpropagation pass; the game is restored afterwards
+    void playout(SearchTree& tree) {
+        auto& game = *tree.game;
+        tree.path.assign(1, 0);
+        tree.moves.clear();
+
+        uint32_t index = 0;
+        while (tree.nodes[index].expanded && tree.nodes[index].childCount > 0) {
+            index = selectChild(tree, tree.nodes[index]);
+            tree.path.push_back(index);
+            (void)game.place(tree.nodes[index].move);
+            tree.moves.push_back(tree.nodes[index].move);
+            if (tree.nodes[index].outcome != ONGOING) break;
+        }
+
+        Reward reward;
+        if (tree.nodes[index].outcome != ONGOING) {
+            reward = terminalReward(tree.nodes[index].outcome, game.numberOfPlayers);
+        } else {
+            if (expand(tree, index)) {
+                const Node& node = tree.nodes[index];
+                index = node.firstChild + static_cast<uint32_t>((nextRandom(tree.random) >> 32) * node.childCount >> 32);
+                tree.path.push_back(index);
+                (void)game.place(tree.nodes[index].move);
+                tree.moves.push_back(tree.nodes[index].move);
+            }
+            reward = tree.nodes[index].outcome != ONGOING
+                         ? terminalReward(tree.nodes[index].outcome, game.numberOfPlayers)
+                         : rollout(tree);
+        }
+
+        for (const auto nodeIndex : tree.path) {
+            Node& node = tree.nodes[nodeIndex];
+            node.visits++;
+            for (uint8_t player = 0; player < game.numberOfPlayers; ++player) {
+                node.rewards[player] += reward[player];
+            }
+        }
+        for (auto it = tree.moves.rbegin(); it != tree.moves.rend(); ++it) {
+            game.unplace(*it);
+        }
+        tree.playouts++;
+    }
+
+    void searchTree(SearchTree& tree, const GameType& root, const uint64_t seed) {
+        tree.game.emplace(root);
+        tree.nodes.clear();
+        tree.nodes.emplace_back();
+        tree.random = zobrist::mix(seed) | 1;
+        tree.playouts = 0;
+
+        unsigned long long unreported = 0;
+        while (!stopped()) {
+            playout(tree);
+            if (++unreported == CHECK_INTERVAL) {
+                checkLimits(unreported);
+                unreported = 0;
+            }
+        }
+    }
+
+public:
+    // The node arenas are allocated on the first search; memoryMB is their total budget over all threads
+    explicit MCTS(const std::size_t memoryMB = 64, const unsigned threads = std::thread::hardware_concurrency())
+        : threadCount(std::max(1u, threads))
+        , memoryBytes(memoryMB * 1024 * 1024)
+    {}
+
+    void setThreads(const unsigned threads) {
+        threadCount = std::max(1u, threads);
+        trees.clear();  // Arenas are resized to the new share of the budget on the next search
+    }
+
+    void stop() noexcept {
+        stopSearch.store(true, std::memory_order_relaxed);
+    }
+
+    // Searches until the time budget or the playout budget (limits.nodes) is spent; maxDepth is ignored
+    MctsResult search(const GameType& game, const SearchLimits& limits) {
+        activeLimits = limits;
+        searchStart = Clock::now();
+        stopSearch.store(false, std::memory_order_relaxed);
+        sharedPlayouts.store(0, std::memory_order_relaxed);
+        searchCount++;
+
+        nodesPerThread = std::max<std::size_t>(memoryBytes / sizeof(Node) / threadCount, 1024);
+        while (trees.size() < threadCount) {
+            trees.push_back(std::make_unique<SearchTree>());
+            trees.back()->nodes.reserve(nodesPerThread);
+        }
+
+        MctsResult result;
+        result.visits.assign(game.board.width, 0);
+        result.rewards.assign(game.numberOfPlayers, 0.0);
+        for (uint16_t col = 0; col < game.board.width; ++col) {
+            if (game.board.canPlace(col)) {
+                result.bestMove = col;
+                break;
+            }
+        }
+        if (result.bestMove == TranspositionTable::NO_MOVE) {
+            return result;
+        }
+
+        ThreadPool::global().ensureWorkers(threadCount - 1);
+        TaskGroup helpers;
+        for (unsigned i = 1; i < threadCount; ++i) {
+            helpers.run([this, &game, i] {
+                searchTree(*trees[i], game, searchCount * threadCount + i);
+            });
+        }
+        searchTree(*trees[0], game, searchCount * threadCount);
+        helpers.wait();
+
+        // Sum the root children of every tree; the most visited column is the most robust choice
+        std::vector<Reward> rewards(game.board.width, Reward{});
+        for (unsigned i = 0; i < threadCount; ++i) {
+            const auto& tree = *trees[i];
+            result.playouts += tree.playouts;
+            const Node& root = tree.nodes[0];
+            for (uint32_t child = root.firstChild; child < root.firstChild + root.childCount; ++child) {
+                const Node& node = tree.nodes[child];
+                result.visits[node.move] += node.visits;
+                for (uint8_t player = 0; player < game.numberOfPlayers; ++player) {
+                    rewards[node.move][player] += node.rewards[player];
+                }
+            }
+        }
+
+        uint32_t bestVisits = 0;
+        for (uint16_t col = 0; col < game.board.width; ++col) {
+            if (result.visits[col] > bestVisits) {
+                bestVisits = result.visits[col];
+                result.bestMove = col;
+            }
+        }
+        for (uint8_t player = 0; player < game.numberOfPlayers && bestVisits > 0; ++player) {
+            result.rewards[player] = rewards[result.bestMove][player] / bestVisits;
+        }
+
+        result.time = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - searchStart);
+        return result;
+    }
+};
@@ -0,0 +1,463 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "Board.hpp"
+#include "Game.hpp"
+#include "SearchStats.hpp"
+#include "Solver.hpp"
+#include "Symmetry.hpp"
+#include "TranspositionTable.hpp"
+#include "Zobrist.hpp"
+
+enum class MultiplayerStrategy {
+    MAXN,      // Every player maximizes its own share of a constant-sum value vector
+    PARANOID,  // All other players minimize the side to move's score, reducing to two-player alpha-beta
+};
+
+// Depth-limited search for games with any number of players, instantiated for Game and FixedGame.
+// Max^n backs up a value vector per node and uses shallow pruning, which is sound because the
+// components are non-negative and never sum to more than MAX_SUM. Paranoid search scores every
+// position for the root player only and runs full alpha-beta with transposition table bounds.
+// Both deepen iteratively under the same depth/time/node budget as Solver and order moves by the
+// table move, then history, then center-first.
+template<typename GameType>
+class MultiplayerSolver {
+private:
+    using BoardType = std::remove_cvref_t<decltype(std::declval<GameType>().board)>;
+    static constexpr bool fixedSize = !std::is_same_v<BoardType, Board>;
+
+    using Values = std::array<int, Board::MAX_PLAYERS>;
+    using Bound = TranspositionTable::Bound;
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int MAX_SEARCH_DEPTH = 64;
+    static constexpr int INF = std::numeric_limits<int>::max();
+    static constexpr int WIN_SCORE = 1000000;                  // Paranoid win, scaled by remaining depth
+    static constexpr int HEURISTIC_SUM = 1 << 15;              // Max^n: leaves share this, wins score above
+    static constexpr int MAX_SUM = HEURISTIC_SUM + 1 + MAX_SEARCH_DEPTH;  // Largest value vector sum, a win
+    static constexpr int TWO_WEIGHT = 10;
+    static constexpr int THREE_WEIGHT = 100;
+    static constexpr unsigned long long CHECK_INTERVAL = 1024;  // Nodes between budget checks
+
+    MultiplayerStrategy strategy;
+    TranspositionTable transpositionTable;
+
+    std::optional<GameType> game;  // Working copy the tree is walked on in place
+    uint8_t rootPlayer{1};
+    uint64_t keySalt{0};
+    uint16_t rootBestMove{TranspositionTable::NO_MOVE};
+    bool rootSymmetric{false};  // Only one column of every mirrored pair is searched at the root
+    unsigned long long nodeCount{0};
+    SearchStats stats;
+    std::atomic<bool> stopSearch{false};
+    SearchLimits activeLimits;
+    Clock::time_point searchStart;
+
+    std::vector<uint16_t> columnOrder;
+    uint64_t dynamicBoardMask{0};      // Playable cells of a bitboard-backed Board
+    std::vector<uint16_t> moveBuffer;  // One width-sized slice per ply
+    std::vector<int> history;          // Cutoff credit per (player, column)
+
+    [[nodiscard]] bool stopped() const noexcept {
+        return stopSearch.load(std::memory_order_relaxed);
+    }
+
+    void checkLimits() noexcept {
+        if ((activeLimits.nodes != 0 && nodeCount >= activeLimits.nodes) ||
+            (activeLimits.time.count() != 0 && Clock::now() - searchStart >= activeLimits.time)) {
+            stopSearch.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    // Paranoid scores depend on the root player, so each (strategy, root player) pair keys its own entries.
+    // Keys are shared with the mirror image; stored moves are in the key's orientation.
+    [[nodiscard]] CanonicalKey keyOf() const noexcept {
+        return canonicalBoardKey(game->board, zobrist::sideKey(game->currentPlayer) ^ keySalt);
+    }
+
+    template<typename Mask>
+    [[nodiscard]] static int popcount(const Mask mask) noexcept {
+        if constexpr (sizeof(Mask) > sizeof(uint64_t)) {
+            return std::popcount(static_cast<uint64_t>(mask)) + std::popcount(static_cast<uint64_t>(mask >> 64));
+        } else {
+            return std::popcount(mask);
+        }
+    }
+
+    // Windows of four cells free of opponents, weighted by how many of them the player already holds.
+    // Bit-sliced: (a, x) and (b, y) are the carry and sum bits of the first and second pair of cells.
+    template<typename Mask>
+    static void scoreWindows(const std::span<const Mask> masks, const uint8_t players, const Mask boardMask,
+                             const uint16_t height, Values& scores) noexcept {
+        Mask occupied{0};
+        for (uint8_t player = 0; player < players; ++player) occupied |= masks[player];
+
+        for (uint8_t player = 0; player < players; ++player) {
+            const Mask own = masks[player];
+            const Mask free = boardMask & ~(occupied ^ own);
+            const unsigned h = height;
+            for (const unsigned shift : {1u, h + 1, h, h + 2}) {
+                // A window this long in this direction cannot fit the board (and the shift would overflow)
+                if (3 * shift >= sizeof(Mask) * 8) continue;
+                const Mask starts = free & (free >> shift) & (free >> 2 * shift) & (free >> 3 * shift);
+                const Mask c1 = own, c2 = own >> shift, c3 = own >> 2 * shift, c4 = own >> 3 * shift;
+                const Mask a = c1 & c2, b = c3 & c4, x = c1 ^ c2, y = c3 ^ c4;
+                const Mask three = starts & ((a & y) | (b & x));
+                const Mask two = starts & ((a & ~(c3 | c4)) | (b & ~(c1 | c2)) | (x & y));
+                scores[player] += THREE_WEIGHT * popcount(three) + TWO_WEIGHT * popcount(two);
+            }
+        }
+    }
+
+    // Same windows read cell by cell, for boards too large for a bitboard
+    static void scoreWindowsByCell(const BoardType& board, Values& scores) noexcept {
+        constexpr std::array<std::pair<int, int>, 4> directions = {{{0, 1}, {1, 0}, {1, 1}, {1, -1}}};
+        for (int row = 0; row < board.height; ++row) {
+            for (int col = 0; col < board.width; ++col) {
+                for (const auto& [dRow, dCol] : directions) {
+                    const int endRow = row + 3 * dRow, endCol = col + 3 * dCol;
+                    if (endRow >= board.height || endCol < 0 || endCol >= board.width) continue;
+                    uint8_t owner = 0;
+                    int count = 0;
+                    for (int i = 0; i < 4 && owner != 0xFF; ++i) {
+                        const auto piece = board.cell(row + i * dRow, col + i * dCol);
+                        if (piece == 0) continue;
+                        owner = owner == 0 || owner == piece ? piece : 0xFF;
+                        ++count;
+                    }
+                    if (owner == 0 || owner == 0xFF) continue;
+                    scores[owner - 1] += count == 3 ? THREE_WEIGHT : count == 2 ? TWO_WEIGHT : 0;
+                }
+            }
+        }
+    }
+
+    // Non-negative heuristic per player: open windows plus pieces in the center column
+    [[nodiscard]] Values heuristics() const noexcept {
+        const auto& board = game->board;
+        const uint8_t players = game->numberOfPlayers;
+        Values scores{};
+        scores.fill(1);
+
+        if constexpr (fixedSize) {
+            scoreWindows<typename BoardType::Mask>(board.bitboardMasks(), players, BoardType::boardMask,
+                                                   BoardType::height, scores);
+        } else if (board.usesBitboard()) {
+            scoreWindows<uint64_t>(board.bitboardMasks(), players, dynamicBoardMask, board.height, scores);
+        } else {
+            scoreWindowsByCell(board, scores);
+        }
+
+        const uint16_t center = board.width / 2;
+        for (uint16_t row = board.height - board.heights[center]; row < board.height; ++row) {
+            scores[board.cell(row, center) - 1] += 3;
+        }
+        return scores;
+    }
+
+    // Max^n leaf: the heuristics rescaled to shares of HEURISTIC_SUM
+    [[nodiscard]] Values shares() const noexcept {
+        const auto scores = heuristics();
+        long long total = 0;
+        for (uint8_t player = 0; player < game->numberOfPlayers; ++player) total += scores[player];
+        Values values{};
+        [[maybe_unused]] long long sum = 0;
+        for (uint8_t player = 0; player < game->numberOfPlayers; ++player) {
+            // In 64 bits: window scores of large boards pass 2^16, and the product would overflow an int
+            values[player] = static_cast<int>(static_cast<long long>(HEURISTIC_SUM) * scores[player] / total);
+            sum += values[player];
+        }
+        assert(sum <= HEURISTIC_SUM);  // Shallow pruning relies on it
+        return values;
+    }
+
+    // Paranoid leaf: root player's heuristic against the average of the others
+    [[nodiscard]] int paranoidScore() const noexcept {
+        const auto scores = heuristics();
+        int score = 0;
+        for (uint8_t player = 1; player <= game->numberOfPlayers; ++player) {
+            score += player == rootPlayer ? (game->numberOfPlayers - 1) * scores[player - 1] : -scores[player - 1];
+        }
+        return score;
+    }
+
+    [[nodiscard]] Values terminalValues(const MoveResult& result, const uint8_t mover, const int depth) const noexcept {
+        Values values{};
+        if (result.result.win) {
+            values[mover - 1] = HEURISTIC_SUM + 1 + depth;  // Faster wins are worth more
+        } else {
+            std::fill_n(values.begin(), game->numberOfPlayers, HEURISTIC_SUM / game->numberOfPlayers);
+        }
+        return values;
+    }
+
+    [[nodiscard]] std::span<uint16_t> orderMoves(const int ply, const uint16_t ttMove) {
+        const auto width = game->board.width;
+        const std::span<uint16_t> moves(moveBuffer.data() + static_cast<std::size_t>(ply) * width, width);
+        const auto* playerHistory = history.data() + static_cast<std::size_t>(game->currentPlayer - 1) * width;
+        const auto priority = [&](const uint16_t col) {
+            return col == ttMove ? INF : playerHistory[col];
+        };
+
+        std::size_t count = 0;
+        for (const uint16_t col : columnOrder) {
+            if (!game->board.canPlace(col) || (ply == 0 && rootSymmetric && isMirroredColumn(col, width))) continue;
+            // Insertion sort keeps the center-first order among equal priorities
+            const auto value = priority(col);
+            auto pos = count++;
+            while (pos > 0 && priority(moves[pos - 1]) < value) {
+                moves[pos] = moves[pos - 1];
+                --pos;
+            }
+            moves[pos] = col;
+        }
+        return moves.first(count);
+    }
+
+    void recordCutoff(const uint16_t col, const int depth) noexcept {
+        history[static_cast<std::size_t>(game->currentPlayer - 1) * game->board.width + col] += depth * depth;
+    }
+
+    [[nodiscard]] bool countNode() noexcept {
+        if (++nodeCount % CHECK_INTERVAL == 0) checkLimits();
+        return !stopped();
+    }
+
+    // parentBest is the best value found so far by the player to move at the parent; once this
+    // player secures MAX_SUM - parentBest, the parent can no longer prefer this node (shallow pruning)
+    Values maxn(const int depth, const int ply, const int parentBest) {
+        if (!countNode()) return {};
+        if (depth == 0) return shares();
+
+        const auto key = keyOf();
+        uint16_t ttMove = TranspositionTable::NO_MOVE;
+        countStat(stats.ttProbes);
+        if (const auto entry = transpositionTable.probe(key.key)) {
+            countStat(stats.ttHits);
+            ttMove = key.orient(entry->bestMove, game->board.width);
+        }
+
+        const uint8_t mover = game->currentPlayer;
+        Values best{};
+        best[mover - 1] = -1;
+        uint16_t bestMove = TranspositionTable::NO_MOVE;
+        unsigned movesSearched = 0;
+        for (const uint16_t col : orderMoves(ply, ttMove)) {
+            ++movesSearched;
+            const auto result = game->place(col);
+            const auto values = result ? terminalValues(*result, mover, depth) : maxn(depth - 1, ply + 1, best[mover - 1]);
+            game->unplace(col);
+            if (stopped()) return best;
+
+            if (values[mover - 1] > best[mover - 1]) {
+                best = values;
+                bestMove = col;
+                if (best[mover - 1] >= MAX_SUM - parentBest) {
+                    recordCutoff(col, depth);
+                    countStat(stats.betaCutoffs);
+                    countStat(stats.firstMoveCutoffs, movesSearched == 1);
+                    break;
+                }
+            }
+        }
+
+        if (ply == 0) rootBestMove = bestMove;
+        // Value vectors do not fit the table, so max^n entries only carry the best move for ordering
+        // (their salted keys never collide with paranoid entries, which do read the score)
+        transpositionTable.store(key.key, 0, depth, Bound::LOWER, key.orient(bestMove, game->board.width));
+        countStat(stats.ttStores);
+        return best;
+    }
+
+    int paranoid(const int depth, const int ply, int alpha, int beta) {
+        if (!countNode()) return 0;
+        if (depth == 0) return paranoidScore();
+
+        const auto key = keyOf();
+        uint16_t ttMove = TranspositionTable::NO_MOVE;
+        countStat(stats.ttProbes);
+        if (const auto entry = transpositionTable.probe(key.key)) {
+            countStat(stats.ttHits);
+            ttMove = key.orient(entry->bestMove, game->board.width);
+            if (entry->depth >= depth && ply > 0) {
+                switch (entry->bound) {
+                    case Bound::EXACT:
+                        countStat(stats.ttCutoffs);
+                        return entry->score;
+                    case Bound::LOWER:
+                        alpha = std::max(alpha, entry->score);
+                        break;
+                    case Bound::UPPER:
+                        beta = std::min(beta, entry->score);
+                        break;
+                    case Bound::NONE:
+                        break;
+                }
+                if (alpha >= beta) {
+                    countStat(stats.ttCutoffs);
+                    return entry->score;
+                }
+            }
+        }
+
+        const uint8_t mover = game->currentPlayer;
+        const bool maximizing = mover == rootPlayer;
+        const int originalAlpha = alpha, originalBeta = beta;
+        int best = maximizing ? -INF : INF;
+        uint16_t bestMove = TranspositionTable::NO_MOVE;
+        unsigned movesSearched = 0;
+        for (const uint16_t col : orderMoves(ply, ttMove)) {
+            ++movesSearched;
+            int score;
+            if (const auto result = game->place(col)) {
+                score = !result->result.win ? 0 : maximizing ? WIN_SCORE * (depth + 1) : -WIN_SCORE * (depth + 1);
+            } else {
+                score = paranoid(depth - 1, ply + 1, alpha, beta);
+            }
+            game->unplace(col);
+            if (stopped()) return best;
+
+            if (maximizing ? score > best : score < best) {
+                best = score;
+                bestMove = col;
+            }
+            if (maximizing) alpha = std::max(alpha, score);
+            else beta = std::min(beta, score);
+            if (alpha >= beta) {
+                recordCutoff(col, depth);
+                countStat(stats.betaCutoffs);
+                countStat(stats.firstMoveCutoffs, movesSearched == 1);
+                break;
+            }
+        }
+
+        if (ply == 0) rootBestMove = bestMove;
+        const auto bound = best <= originalAlpha ? Bound::UPPER : best >= originalBeta ? Bound::LOWER : Bound::EXACT;
+        transpositionTable.store(key.key, best, depth, bound, key.orient(bestMove, game->board.width));
+        countStat(stats.ttStores);
+        return best;
+    }
+
+    // Follows best moves stored in the transposition table from the root
+    [[nodiscard]] std::vector<uint16_t> principalVariation(const int depth) {
+        std::vector<uint16_t> pv;
+        auto move = rootBestMove;
+        while (move != TranspositionTable::NO_MOVE && static_cast<int>(pv.size()) < depth &&
+               game->board.canPlace(move)) {
+            pv.push_back(move);
+            if (game->place(move)) break;
+            const auto key = keyOf();
+            const auto entry = transpositionTable.probe(key.key);
+            move = entry ? key.orient(entry->bestMove, game->board.width) : TranspositionTable::NO_MOVE;
+        }
+        for (auto it = pv.rbegin(); it != pv.rend(); ++it) {
+            game->unplace(*it);
+        }
+        return pv;
+    }
+
+public:
+    explicit MultiplayerSolver(const MultiplayerStrategy strategy = MultiplayerStrategy::PARANOID,
+                               const std::size_t hashSizeMB = TranspositionTable::DEFAULT_SIZE_MB)
+        : strategy(strategy)
+        , transpositionTable(hashSizeMB)
+    {}
+
+    void setHashSize(const std::size_t megabytes) {
+        transpositionTable.resize(megabytes);
+    }
+
+    void setStrategy(const MultiplayerStrategy newStrategy) noexcept {
+        strategy = newStrategy;
+    }
+
+    void stop() noexcept {
+        stopSearch.store(true, std::memory_order_relaxed);
+    }
+
+    // Forgets every stored position; entries otherwise persist across moves and games
+    void newGame() noexcept {
+        transpositionTable.clear();
+    }
+
+    // Iterative deepening under the limits; score is the root player's max^n share or paranoid score
+    SearchResult search(const GameType& root, const SearchLimits& limits) {
+        transpositionTable.newSearch();
+        game.emplace(root);
+        rootPlayer = root.currentPlayer;
+        keySalt = zobrist::mix(0xA5A5A5A5ULL + rootPlayer * 2 + static_cast<uint64_t>(strategy));
+        rootSymmetric = isMirrorSymmetric(root.board);
+        activeLimits = limits;
+        searchStart = Clock::now();
+        stopSearch.store(false, std::memory_order_relaxed);
+        nodeCount = 0;
+        stats = {};
+
+        const auto width = root.board.width;
+        columnOrder.resize(width);
+        centerFirstColumnOrder(columnOrder);
+        history.assign(static_cast<std::size_t>(Board::MAX_PLAYERS) * width, 0);
+        if constexpr (!fixedSize) {
+            if (root.board.usesBitboard()) {
+                uint64_t bottom = 0;
+                for (uint16_t col = 0; col < width; ++col) bottom |= uint64_t{1} << (col * (root.board.height + 1));
+                dynamicBoardMask = bottom * ((uint64_t{1} << root.board.height) - 1);
+            }
+        }
+
+        const int remaining = root.board.maxMoves - root.board.movesPlayed;
+        const int maxDepth = std::clamp(limits.maxDepth, 1, std::max(1, std::min(remaining, MAX_SEARCH_DEPTH)));
+        moveBuffer.assign(static_cast<std::size_t>(maxDepth + 1) * width, 0);
+
+        SearchResult result;
+        for (const uint16_t col : columnOrder) {
+            if (root.board.canPlace(col)) {
+                result.bestMove = col;
+                break;
+            }
+        }
+
+        for (int depth = 1; depth <= maxDepth && remaining > 0 && !stopped(); ++depth) {
+            rootBestMove = TranspositionTable::NO_MOVE;
+            const auto iterationStart = nodeCount;
+            int score;
+            if (strategy == MultiplayerStrategy::MAXN) {
+                score = maxn(depth, 0, 0)[rootPlayer - 1];
+            } else {
+                score = paranoid(depth, 0, -INF, INF);
+            }
+            if (stopped() || rootBestMove == TranspositionTable::NO_MOVE) break;
+
+            result.bestMove = rootBestMove;
+            result.score = score;
+            result.depth = depth;
+            result.depthTimes.push_back(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - searchStart));
+            if constexpr (SearchStats::enabled) {
+                stats.iterations.push_back({depth, nodeCount - iterationStart, result.depthTimes.back()});
+            }
+        }
+
+        rootBestMove = result.bestMove;
+        result.nodes = nodeCount;
+        if constexpr (SearchStats::enabled) stats.nodes = nodeCount;
+        result.stats = std::move(stats);
+        result.time = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - searchStart);
+        result.pv = principalVariation(result.depth);
+        return result;
+    }
+
+    [[nodiscard]] unsigned long long getNodeCount() const {
+        return nodeCount;
+    }
+};
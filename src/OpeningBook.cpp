@@ -0,0 +1,94 @@
+#include "OpeningBook.hpp"
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+OpeningBook::~OpeningBook() {
+    close();
+}
+
+std::expected<void, std::string> OpeningBook::open(const std::string& path) {
+    close();
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return std::unexpected("Cannot open opening book " + path);
+    }
+
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(Header)) {
+        ::close(fd);
+        return std::unexpected("Opening book is truncated");
+    }
+
+    const auto fileSize = static_cast<std::size_t>(info.st_size);
+    void* data = ::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping stays valid after the descriptor is closed
+    if (data == MAP_FAILED) {
+        return std::unexpected("Failed to map opening book");
+    }
+
+    const auto* fileHeader = static_cast<const Header*>(data);
+    const auto entryCount = fileHeader->entryCount;
+    if (std::memcmp(fileHeader->magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        fileSize != sizeof(Header) + entryCount * (sizeof(uint64_t) + sizeof(BookEntry))) {
+        ::munmap(data, fileSize);
+        return std::unexpected("Not a valid opening book");
+    }
+
+    const auto* base = static_cast<const std::byte*>(data);
+    mapping = data;
+    mappingSize = fileSize;
+    header = fileHeader;
+    keys = {reinterpret_cast<const uint64_t*>(base + sizeof(Header)), entryCount};
+    values = reinterpret_cast<const BookEntry*>(base + sizeof(Header) + entryCount * sizeof(uint64_t));
+    return {};
+}
+
+void OpeningBook::close() noexcept {
+    if (mapping) {
+        ::munmap(mapping, mappingSize);
+    }
+    mapping = nullptr;
+    mappingSize = 0;
+    header = nullptr;
+    keys = {};
+    values = nullptr;
+}
+
+std::expected<void, std::string>
+OpeningBook::write(const std::string& path, const uint16_t width, const uint16_t height, const uint16_t plies,
+                   std::vector<std::pair<uint64_t, BookEntry>> entries) {
+    std::ranges::sort(entries, {}, &std::pair<uint64_t, BookEntry>::first);
+    const auto duplicates = std::ranges::unique(entries, {}, &std::pair<uint64_t, BookEntry>::first);
+    entries.erase(duplicates.begin(), duplicates.end());
+
+    Header fileHeader{};
+    std::memcpy(fileHeader.magic, MAGIC, sizeof(MAGIC));
+    fileHeader.width = width;
+    fileHeader.height = height;
+    fileHeader.plies = plies;
+    fileHeader.entryCount = entries.size();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return std::unexpected("Cannot create opening book " + path);
+    }
+
+    out.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+    for (const auto& [key, entry] : entries) {
+        out.write(reinterpret_cast<const char*>(&key), sizeof(key));
+    }
+    for (const auto& [key, entry] : entries) {
+        out.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    }
+
+    if (!out) {
+        return std::unexpected("Failed to write opening book " + path);
+    }
+    return {};
+}
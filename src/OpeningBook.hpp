@@ -0,0 +1,88 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Symmetry.hpp"
+
+struct BookEntry {
+    uint16_t move;  // Best column, in the orientation of the stored (canonical) position
+    int16_t score;  // Score of the best move for the side to move
+};
+
+// Read-only opening book memory-mapped straight from disk.
+// File layout: Header, then entryCount sorted uint64_t canonical keys, then entryCount BookEntry
+// values in the same order. Lookups binary-search the mapped keys, so opening a book costs one mmap
+// call and nothing is deserialized.
+class OpeningBook {
+public:
+    static constexpr char MAGIC[8] = {'C', '4', 'B', 'O', 'O', 'K', '1', '\0'};
+
+    struct Header {
+        char magic[8];
+        uint16_t width;
+        uint16_t height;
+        uint16_t plies;
+        uint16_t reserved;
+        uint64_t entryCount;
+        uint64_t padding;
+    };
+    static_assert(sizeof(Header) == 32);
+
+    OpeningBook() = default;
+    ~OpeningBook();
+
+    OpeningBook(const OpeningBook&) = delete;
+    OpeningBook& operator=(const OpeningBook&) = delete;
+
+    [[nodiscard]] std::expected<void, std::string> open(const std::string& path);
+    void close() noexcept;
+
+    [[nodiscard]] bool isOpen() const noexcept {
+        return header != nullptr;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return keys.size();
+    }
+
+    // Book move for the position, already mapped back to the game's orientation
+    template<typename GameType>
+    [[nodiscard]] std::optional<BookEntry> probe(const GameType& game) const noexcept {
+        if (!isOpen() || game.board.width != header->width || game.board.height != header->height ||
+            game.board.movesPlayed > header->plies) {
+            return std::nullopt;
+        }
+
+        const auto canonical = canonicalKey(game);
+        auto entry = find(canonical.key);
+        if (entry) {
+            entry->move = canonical.orient(entry->move, game.board.width);
+        }
+        return entry;
+    }
+
+    // Writes a book file; entries are keyed by canonicalKey() and may be in any order
+    [[nodiscard]] static std::expected<void, std::string>
+    write(const std::string& path, uint16_t width, uint16_t height, uint16_t plies,
+          std::vector<std::pair<uint64_t, BookEntry>> entries);
+
+private:
+    const Header* header{nullptr};
+    std::span<const uint64_t> keys;
+    const BookEntry* values{nullptr};
+    void* mapping{nullptr};
+    std::size_t mappingSize{0};
+
+    [[nodiscard]] std::optional<BookEntry> find(const uint64_t key) const noexcept {
+        const auto it = std::ranges::lower_bound(keys, key);
+        if (it == keys.end() || *it != key) return std::nullopt;
+        return values[it - keys.begin()];
+    }
+};
@@ -0,0 +1,296 @@
+#include "Protocol.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <expected>
+#include <format>
+#include <istream>
+#include <optional>
+#include <print>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "AI.hpp"
+#include "FixedGame.hpp"
+#include "Game.hpp"
+#include "MultiplayerSolver.hpp"
+#include "Solver.hpp"
+#include "Tablebase.hpp"
+
+namespace {
+    struct EngineOptions {
+        unsigned threads{std::max(1u, std::thread::hardware_concurrency())};
+        std::size_t hashMB{TranspositionTable::DEFAULT_SIZE_MB};
+        MultiplayerStrategy strategy{MultiplayerStrategy::PARANOID};
+        const Tablebase* tablebase{nullptr};
+    };
+
+    // One solver per board shape, kept for the whole session so its table carries over between requests
+    template<typename GameType>
+    Solver<GameType>& solverFor(const EngineOptions& options) {
+        static Solver<GameType> solver(options.hashMB, options.threads);
+        static std::size_t hashMB = options.hashMB;
+        if (hashMB != options.hashMB) {
+            solver.setHashSize(options.hashMB);
+            hashMB = options.hashMB;
+        }
+        solver.setThreads(options.threads);
+        solver.setTablebase(options.tablebase);
+        return solver;
+    }
+
+    MultiplayerSolver<Game>& multiplayerSolver(const EngineOptions& options) {
+        static MultiplayerSolver<Game> solver(options.strategy, options.hashMB);
+        static std::size_t hashMB = options.hashMB;
+        if (hashMB != options.hashMB) {
+            solver.setHashSize(options.hashMB);
+            hashMB = options.hashMB;
+        }
+        solver.setStrategy(options.strategy);
+        return solver;
+    }
+
+    [[nodiscard]] std::vector<std::string_view> splitWords(const std::string_view line) {
+        std::vector<std::string_view> words;
+        std::size_t pos = 0;
+        while (pos < line.size()) {
+            const auto start = line.find_first_not_of(" \t\r", pos);
+            if (start == std::string_view::npos) break;
+            const auto end = std::min(line.find_first_of(" \t\r", start), line.size());
+            words.push_back(line.substr(start, end - start));
+            pos = end;
+        }
+        return words;
+    }
+
+    template<typename T>
+    [[nodiscard]] std::expected<T, std::string> parseNumber(const std::string_view word) {
+        T value{};
+        const auto [end, error] = std::from_chars(word.data(), word.data() + word.size(), value);
+        if (error != std::errc{} || end != word.data() + word.size()) {
+            return std::unexpected(std::format("Invalid number {}", word));
+        }
+        return value;
+    }
+
+    class Session {
+    public:
+        // Runs one command; false once the session should end
+        bool execute(const std::string_view line) {
+            const auto words = splitWords(line);
+            if (words.empty()) return true;
+
+            const auto command = words[0];
+            const std::span arguments(words.begin() + 1, words.end());
+            std::expected<void, std::string> status;
+            if (command == "quit") return false;
+            if (command == "isready") std::println("readyok");
+            else if (command == "size") status = setSize(arguments);
+            else if (command == "position") status = setPosition(arguments);
+            else if (command == "go") status = go(arguments);
+            else if (command == "threads") status = setThreads(arguments);
+            else if (command == "hash") status = setHash(arguments);
+            else if (command == "strategy") status = setStrategy(arguments);
+            else if (command == "tablebase") status = loadTablebase(arguments);
+            else if (command == "newgame") newGame();
+            else status = std::unexpected(std::format("Unknown command {}", command));
+
+            if (!status) {
+                std::println("error {}", status.error());
+            }
+            return true;
+        }
+
+    private:
+        EngineOptions options;
+        Tablebase tablebase;
+        std::optional<Game> game{std::in_place, 7, 6, 2};
+        bool gameOver{false};
+
+        std::expected<void, std::string> setSize(const std::span<const std::string_view> arguments) {
+            if (arguments.size() < 2 || arguments.size() > 3) {
+                return std::unexpected("Usage: size <width> <height> [players]");
+            }
+            const auto width = parseNumber<uint16_t>(arguments[0]);
+            const auto height = parseNumber<uint16_t>(arguments[1]);
+            const auto players = arguments.size() == 3 ? parseNumber<unsigned>(arguments[2]) : 2u;
+            if (!width) return std::unexpected(width.error());
+            if (!height) return std::unexpected(height.error());
+            if (!players) return std::unexpected(players.error());
+            const bool sameShape = game->width == *width && game->height == *height && game->numberOfPlayers == *players;
+            try {
+                game.emplace(*width, *height, static_cast<uint8_t>(std::min(*players, 255u)));
+            } catch (const std::exception& e) {
+                return std::unexpected(e.what());
+            }
+            gameOver = false;
+            // Keys leave out the board size and every other shape shares one solver, so its entries
+            // would be read as positions of this board
+            if (!sameShape) newGame();
+            return {};
+        }
+
+        std::expected<void, std::string> setPosition(const std::span<const std::string_view> arguments) {
+            // Columns are expanded before touching the game so a bad move leaves the old position intact
+            std::vector<uint16_t> moves;
+            for (const auto word : arguments) {
+                if (game->width <= 10 && word.size() > 1) {
+                    for (const char digit : word) {
+                        if (digit < '0' || digit > '9') return std::unexpected(std::format("Invalid move string {}", word));
+                        moves.push_back(static_cast<uint16_t>(digit - '0'));
+                    }
+                } else if (const auto col = parseNumber<uint16_t>(word)) {
+                    moves.push_back(*col);
+                } else {
+                    return std::unexpected(col.error());
+                }
+            }
+
+            Game position(game->width, game->height, game->numberOfPlayers);
+            bool over = false;
+            for (std::size_t i = 0; i < moves.size(); ++i) {
+                if (over) return std::unexpected(std::format("Move {} is played after the game ended", i + 1));
+                if (moves[i] >= position.width || !position.board.canPlace(moves[i])) {
+                    return std::unexpected(std::format("Move {} (column {}) is not playable", i + 1, moves[i]));
+                }
+                over = position.place(moves[i]).has_value();
+            }
+            game.emplace(std::move(position));
+            gameOver = over;
+            return {};
+        }
+
+        std::expected<void, std::string> go(const std::span<const std::string_view> arguments) {
+            SearchLimits limits;
+            bool analyze = false;
+            bool withStats = false;
+            for (std::size_t i = 0; i < arguments.size(); ++i) {
+                const auto name = arguments[i];
+                if (name == "analyze") {
+                    analyze = true;
+                    continue;
+                }
+                if (name == "stats") {
+                    withStats = true;
+                    continue;
+                }
+                if (i + 1 >= arguments.size()) return std::unexpected(std::format("Missing value for {}", name));
+                const auto value = parseNumber<unsigned long long>(arguments[++i]);
+                if (!value) return std::unexpected(value.error());
+                if (name == "depth") limits.maxDepth = static_cast<int>(std::min<unsigned long long>(*value, 1000));
+                else if (name == "movetime") limits.time = std::chrono::milliseconds(*value);
+                else if (name == "nodes") limits.nodes = *value;
+                else return std::unexpected(std::format("Unknown limit {}", name));
+            }
+            if (limits.maxDepth == SearchLimits{}.maxDepth && limits.time.count() == 0 && limits.nodes == 0) {
+                limits.time = DEFAULT_MOVE_TIME;
+            }
+            if (analyze && game->numberOfPlayers > 2) {
+                return std::unexpected("analyze needs a two-player game");
+            }
+
+            if (gameOver || game->board.movesPlayed >= game->board.maxMoves) {
+                std::println("bestmove none");
+                return {};
+            }
+
+            SearchResult result;
+            if (game->numberOfPlayers > 2) {
+                result = multiplayerSolver(options).search(*game, limits);
+            } else {
+                result = visitFixedGame(*game, [&](const auto& searchGame) {
+                    using GameType = std::remove_cvref_t<decltype(searchGame)>;
+                    auto& solver = solverFor<GameType>(options);
+                    return analyze ? solver.analyze(searchGame, limits) : solver.search(searchGame, limits);
+                });
+            }
+            printResult(result, analyze, withStats);
+            return {};
+        }
+
+        static void printResult(const SearchResult& result, const bool analyze, const bool withStats) {
+            const auto micros = result.time.count();
+            const auto nps = micros > 0 ? result.nodes * 1000000 / static_cast<unsigned long long>(micros) : 0;
+            std::string line = std::format("bestmove {} score {} depth {} nodes {} time {} nps {} pv",
+                                           result.bestMove, result.score, result.depth, result.nodes, micros, nps);
+            for (const auto move : result.pv) {
+                std::format_to(std::back_inserter(line), " {}", move);
+            }
+            if (analyze) {
+                line += " scores";
+                for (const auto& score : result.columnScores) {
+                    if (score) std::format_to(std::back_inserter(line), " {}", *score);
+                    else line += " -";
+                }
+            }
+            if (withStats) {
+                line += " stats " + result.stats.toJson();
+            }
+            std::println("{}", line);
+        }
+
+        std::expected<void, std::string> setThreads(const std::span<const std::string_view> arguments) {
+            if (arguments.size() != 1) return std::unexpected("Usage: threads <n>");
+            const auto threads = parseNumber<unsigned>(arguments[0]);
+            if (!threads) return std::unexpected(threads.error());
+            options.threads = std::clamp(*threads, 1u, 256u);
+            return {};
+        }
+
+        std::expected<void, std::string> setHash(const std::span<const std::string_view> arguments) {
+            if (arguments.size() != 1) return std::unexpected("Usage: hash <mb>");
+            const auto megabytes = parseNumber<std::size_t>(arguments[0]);
+            if (!megabytes) return std::unexpected(megabytes.error());
+            options.hashMB = std::max<std::size_t>(*megabytes, 1);
+            return {};
+        }
+
+        std::expected<void, std::string> setStrategy(const std::span<const std::string_view> arguments) {
+            if (arguments.size() == 1 && arguments[0] == "paranoid") options.strategy = MultiplayerStrategy::PARANOID;
+            else if (arguments.size() == 1 && arguments[0] == "maxn") options.strategy = MultiplayerStrategy::MAXN;
+            else return std::unexpected("Usage: strategy paranoid|maxn");
+            return {};
+        }
+
+        std::expected<void, std::string> loadTablebase(const std::span<const std::string_view> arguments) {
+            if (arguments.size() != 1) return std::unexpected("Usage: tablebase <path>");
+            options.tablebase = nullptr;
+            if (const auto opened = tablebase.open(std::string(arguments[0])); !opened) {
+                return opened;
+            }
+            options.tablebase = &tablebase;
+            return {};
+        }
+
+        void newGame() {
+            if (game->numberOfPlayers > 2) {
+                multiplayerSolver(options).newGame();
+                return;
+            }
+            visitFixedGame(*game, [&](const auto& searchGame) {
+                solverFor<std::remove_cvref_t<decltype(searchGame)>>(options).newGame();
+            });
+        }
+    };
+}
+
+int runProtocol(std::istream& input) {
+    Session session;
+    std::string line;
+    while (std::getline(input, line)) {
+        const bool running = session.execute(line);
+        // Pipelined requests are answered in one write; an interactive client gets every line at once
+        if (!running || input.rdbuf()->in_avail() <= 0) {
+            std::fflush(stdout);
+        }
+        if (!running) break;
+    }
+    std::fflush(stdout);
+    return 0;
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <iosfwd>
+
+// Headless line protocol for driving the engine from other programs, one command per line:
+//
+//   isready                           -> readyok
+//   size <width> <height> [players]   empty board of that shape (7 6 2 to start with)
+//   position [moves...]               position reached from the empty board by the moves; columns are
+//                                     space separated, or one digit string such as 3342 when width <= 10
+//   go [depth D] [movetime MS] [nodes N] [analyze] [stats]
+//                                     -> bestmove <col|none> score S depth D nodes N time US nps X pv ...
+//                                        with "scores" and one score per column (- when full) if analyze
+//                                        and "stats" and the SearchStats JSON object if stats
+//   threads <n> | hash <mb> | strategy paranoid|maxn
+//   tablebase <path>                  endgame tablebase from ConnectFourTablebase, probed by later searches
+//   newgame                           drops the search tables
+//   quit
+//
+// Every position command describes the whole position, so requests do not depend on earlier ones.
+// Each go is answered by exactly one line, in order, so clients can pipeline many requests; output
+// is flushed whenever no more input is buffered. Malformed commands are answered by "error <reason>".
+int runProtocol(std::istream& input);
@@ -0,0 +1,146 @@
+// Game record tool: writes random games through a Game hooked to a GameRecordWriter, replays record
+// files through Board verifying every recorded result, and prints games as move lists.
+//
+// Usage: ConnectFourRecords generate <file> <games> [--width W] [--height H] [--players P] [--seed S]
+//        ConnectFourRecords replay <file>
+//        ConnectFourRecords dump <file> [--games N]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Game.hpp"
+#include "GameRecord.hpp"
+#include "Zobrist.hpp"
+
+namespace {
+    struct Options {
+        std::string command;
+        std::string path;
+        uint64_t games{0};
+        uint16_t width{7};
+        uint16_t height{6};
+        uint8_t players{2};
+        uint64_t seed{1};
+    };
+
+    int generate(const Options& options) {
+        GameRecordWriter writer;
+        if (const auto opened = writer.open(options.path, options.width, options.height, options.players); !opened) {
+            std::println("{}", opened.error());
+            return 1;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        uint64_t random = zobrist::mix(options.seed) | 1;
+        for (uint64_t i = 0; i < options.games; ++i) {
+            Game game(options.width, options.height, options.players);
+            writer.attach(game);
+            std::optional<MoveResult> result;
+            while (!result) {
+                random = zobrist::mix(random);
+                auto col = static_cast<uint16_t>((random >> 32) * game.width >> 32);
+                while (!game.board.canPlace(col)) col = static_cast<uint16_t>((col + 1) % game.width);
+                result = game.place(col);
+            }
+            writer.finishGame(game, result);
+            writer.detach(game);
+        }
+        if (const auto closed = writer.close(); !closed) {
+            std::println("{}", closed.error());
+            return 1;
+        }
+
+        const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+        std::println("Wrote {} games to {} in {:.2f} seconds", options.games, options.path, duration.count());
+        return 0;
+    }
+
+    int replay(const Options& options) {
+        GameRecordReader reader;
+        if (const auto opened = reader.open(options.path); !opened) {
+            std::println("{}", opened.error());
+            return 1;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto stats = reader.replay();
+        const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+        if (!stats) {
+            std::println("{}", stats.error());
+            return 1;
+        }
+
+        std::println("Replayed {} games, {} moves in {:.3f} seconds ({:.1f}M moves/s)", stats->games, stats->moves,
+                     duration.count(), static_cast<double>(stats->moves) / std::max(duration.count(), 1e-9) / 1e6);
+        if (stats->mismatches > 0) {
+            std::println("{} games disagree with checkWin, the first is game {}", stats->mismatches,
+                         *stats->firstMismatch);
+            return 1;
+        }
+        std::println("Every recorded result matches checkWin");
+        return 0;
+    }
+
+    int dump(const Options& options) {
+        GameRecordReader reader;
+        if (const auto opened = reader.open(options.path); !opened) {
+            std::println("{}", opened.error());
+            return 1;
+        }
+
+        const auto& info = reader.info();
+        std::println("{}x{} board, {} players, {} games, {} moves", info.width, info.height, info.players,
+                     info.gameCount, info.moveCount);
+        auto cursor = reader.games();
+        std::vector<uint16_t> moves;
+        uint8_t outcome;
+        for (uint64_t i = 0; (options.games == 0 || i < options.games) && cursor.next(moves, outcome); ++i) {
+            const auto result = outcome == gamerecord::DRAW ? std::string("draw")
+                              : outcome == gamerecord::UNFINISHED ? std::string("unfinished")
+                              : "player " + std::to_string(outcome) + " won";
+            std::println("{}: {} ({})", i, moves, result);
+        }
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            const auto value = [&] {
+                if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + arg);
+                return std::stoll(argv[++i]);
+            };
+            if (arg == "--width") options.width = static_cast<uint16_t>(value());
+            else if (arg == "--height") options.height = static_cast<uint16_t>(value());
+            else if (arg == "--players") options.players = static_cast<uint8_t>(value());
+            else if (arg == "--seed") options.seed = static_cast<uint64_t>(value());
+            else if (arg == "--games") options.games = static_cast<uint64_t>(std::max(0LL, value()));
+            else if (options.command.empty()) options.command = arg;
+            else if (options.path.empty()) options.path = arg;
+            else if (options.command == "generate" && options.games == 0) options.games = std::stoull(arg);
+            else throw std::invalid_argument("Unknown argument " + arg);
+        }
+
+        if (options.command == "generate" && !options.path.empty()) {
+            Game(options.width, options.height, options.players);  // Validates the shape before creating the file
+            return generate(options);
+        }
+        if (options.command == "replay" && !options.path.empty()) return replay(options);
+        if (options.command == "dump" && !options.path.empty()) return dump(options);
+        throw std::invalid_argument("Missing command or file");
+    } catch (const std::exception& e) {
+        std::println("{}", e.what());
+        std::println("Usage: ConnectFourRecords generate <file> <games> [--width W] [--height H] [--players P] [--seed S]");
+        std::println("       ConnectFourRecords replay <file>");
+        std::println("       ConnectFourRecords dump <file> [--games N]");
+        return 1;
+    }
+}
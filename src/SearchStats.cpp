@@ -0,0 +1,47 @@
+#include "SearchStats.hpp"
+#include <cmath>
+#include <format>
+#include <iterator>
+
+void SearchStats::merge(const SearchStats& other) noexcept {
+    nodes += other.nodes;
+    ttProbes += other.ttProbes;
+    ttHits += other.ttHits;
+    ttCutoffs += other.ttCutoffs;
+    ttStores += other.ttStores;
+    betaCutoffs += other.betaCutoffs;
+    firstMoveCutoffs += other.firstMoveCutoffs;
+    tablebaseHits += other.tablebaseHits;
+}
+
+double SearchStats::ttHitRate() const noexcept {
+    return ttProbes > 0 ? static_cast<double>(ttHits) / static_cast<double>(ttProbes) : 0.0;
+}
+
+double SearchStats::firstMoveCutoffRate() const noexcept {
+    return betaCutoffs > 0 ? static_cast<double>(firstMoveCutoffs) / static_cast<double>(betaCutoffs) : 0.0;
+}
+
+double SearchStats::effectiveBranchingFactor() const noexcept {
+    if (iterations.size() < 2 || iterations.front().nodes == 0) return 0.0;
+    const auto& first = iterations.front();
+    const auto& last = iterations.back();
+    const double ratio = static_cast<double>(last.nodes) / static_cast<double>(first.nodes);
+    return std::pow(ratio, 1.0 / (last.depth - first.depth));
+}
+
+std::string SearchStats::toJson() const {
+    std::string json = std::format(
+        "{{\"enabled\": {}, \"nodes\": {}, \"tt_probes\": {}, \"tt_hits\": {}, \"tt_hit_rate\": {:.4f}, "
+        "\"tt_cutoffs\": {}, \"tt_stores\": {}, \"beta_cutoffs\": {}, \"first_move_cutoffs\": {}, "
+        "\"first_move_cutoff_rate\": {:.4f}, \"tablebase_hits\": {}, \"effective_branching_factor\": {:.3f}, "
+        "\"iterations\": [",
+        enabled, nodes, ttProbes, ttHits, ttHitRate(), ttCutoffs, ttStores, betaCutoffs, firstMoveCutoffs,
+        firstMoveCutoffRate(), tablebaseHits, effectiveBranchingFactor());
+    for (std::size_t i = 0; i < iterations.size(); ++i) {
+        std::format_to(std::back_inserter(json), "{}{{\"depth\": {}, \"nodes\": {}, \"time_us\": {}}}",
+                       i == 0 ? "" : ", ", iterations[i].depth, iterations[i].nodes, iterations[i].time.count());
+    }
+    json += "]}";
+    return json;
+}
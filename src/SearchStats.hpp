@@ -0,0 +1,49 @@
+#pragma once
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Search counters are compiled in unless CONNECT_FOUR_SEARCH_STATS is defined to 0 (the CMake option of
+// the same name). Compiled out, every countStat() is a no-op and the returned SearchStats stays zero.
+#ifndef CONNECT_FOUR_SEARCH_STATS
+#define CONNECT_FOUR_SEARCH_STATS 1
+#endif
+
+// One completed iterative deepening iteration
+struct IterationStats {
+    int depth;
+    unsigned long long nodes;        // Visited by the main search thread during this iteration
+    std::chrono::microseconds time;  // Since the search started
+};
+
+// Counters of one search. Every search thread fills its own copy without synchronization and the
+// copies are merged once the threads are done.
+struct SearchStats {
+    static constexpr bool enabled = CONNECT_FOUR_SEARCH_STATS != 0;
+
+    unsigned long long nodes{0};
+    unsigned long long ttProbes{0};
+    unsigned long long ttHits{0};
+    unsigned long long ttCutoffs{0};         // Nodes answered by a table bound without searching
+    unsigned long long ttStores{0};
+    unsigned long long betaCutoffs{0};
+    unsigned long long firstMoveCutoffs{0};  // Beta cutoffs caused by the first move searched
+    unsigned long long tablebaseHits{0};     // Nodes answered by the endgame tablebase
+    std::vector<IterationStats> iterations;
+
+    // Adds the counters of another thread; the iterations of this object are kept
+    void merge(const SearchStats& other) noexcept;
+
+    [[nodiscard]] double ttHitRate() const noexcept;
+    [[nodiscard]] double firstMoveCutoffRate() const noexcept;
+
+    // Geometric mean growth of the main thread's nodes per iteration, 0 with fewer than two iterations
+    [[nodiscard]] double effectiveBranchingFactor() const noexcept;
+
+    [[nodiscard]] std::string toJson() const;
+};
+
+// Hot-path increment that disappears when statistics are compiled out
+inline void countStat(unsigned long long& counter, const unsigned long long amount = 1) noexcept {
+    if constexpr (SearchStats::enabled) counter += amount;
+}
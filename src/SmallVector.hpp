@@ -0,0 +1,167 @@
+#pragma once
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+// Vector of trivially copyable elements that keeps up to N of them inside the object and moves to the
+// heap only beyond that. Copies of small contents never allocate and copy only the elements in use.
+// Growth past the inline capacity reallocates like std::vector; reserve() up front keeps it out of
+// hot paths.
+template<typename T, std::size_t N>
+class SmallVector {
+    static_assert(std::is_trivially_copyable_v<T> && N > 0);
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector() noexcept = default;
+
+    explicit SmallVector(const std::size_t count, const T& value = T{}) {
+        resize(count, value);
+    }
+
+    SmallVector(const SmallVector& other) {
+        reserve(other.count);
+        copyFrom(other);
+    }
+
+    SmallVector(SmallVector&& other) noexcept {
+        takeFrom(other);
+    }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            count = 0;
+            reserve(other.count);
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept {
+        if (this != &other) {
+            release();
+            takeFrom(other);
+        }
+        return *this;
+    }
+
+    ~SmallVector() {
+        release();
+    }
+
+    [[nodiscard]] T* data() noexcept { return elements; }
+    [[nodiscard]] const T* data() const noexcept { return elements; }
+    [[nodiscard]] std::size_t size() const noexcept { return count; }
+    [[nodiscard]] std::size_t capacity() const noexcept { return limit; }
+    [[nodiscard]] bool empty() const noexcept { return count == 0; }
+
+    // True while the elements live inside the object
+    [[nodiscard]] bool isInline() const noexcept {
+        return elements == inlineElements();
+    }
+
+    [[nodiscard]] iterator begin() noexcept { return elements; }
+    [[nodiscard]] iterator end() noexcept { return elements + count; }
+    [[nodiscard]] const_iterator begin() const noexcept { return elements; }
+    [[nodiscard]] const_iterator end() const noexcept { return elements + count; }
+
+    [[nodiscard]] T& operator[](const std::size_t index) noexcept { return elements[index]; }
+    [[nodiscard]] const T& operator[](const std::size_t index) const noexcept { return elements[index]; }
+    [[nodiscard]] T& back() noexcept { return elements[count - 1]; }
+    [[nodiscard]] const T& back() const noexcept { return elements[count - 1]; }
+
+    void push_back(const T& value) {
+        if (count == limit) {
+            reserve(limit * 2);
+        }
+        ::new (elements + count) T(value);
+        ++count;
+    }
+
+    void pop_back() noexcept {
+        --count;
+    }
+
+    void clear() noexcept {
+        count = 0;
+    }
+
+    void resize(const std::size_t newCount, const T& value = T{}) {
+        reserve(newCount);
+        for (auto i = count; i < newCount; ++i) {
+            ::new (elements + i) T(value);
+        }
+        count = newCount;
+    }
+
+    void reserve(const std::size_t newLimit) {
+        if (newLimit <= limit) return;
+        auto* grown = static_cast<T*>(::operator new(newLimit * sizeof(T), std::align_val_t{alignof(T)}));
+        if (count > 0) {
+            std::memcpy(grown, elements, count * sizeof(T));
+        }
+        release();
+        elements = grown;
+        limit = newLimit;
+    }
+
+    friend bool operator==(const SmallVector& a, const SmallVector& b) noexcept {
+        return std::ranges::equal(a, b);
+    }
+
+    friend auto operator<=>(const SmallVector& a, const SmallVector& b) noexcept {
+        return std::lexicographical_compare_three_way(a.begin(), a.end(), b.begin(), b.end());
+    }
+
+private:
+    alignas(T) std::byte storage[N * sizeof(T)];
+    T* elements{inlineElements()};
+    std::size_t count{0};
+    std::size_t limit{N};
+
+    [[nodiscard]] T* inlineElements() noexcept {
+        return std::launder(reinterpret_cast<T*>(storage));
+    }
+
+    [[nodiscard]] const T* inlineElements() const noexcept {
+        return std::launder(reinterpret_cast<const T*>(storage));
+    }
+
+    void copyFrom(const SmallVector& other) noexcept {
+        if (other.count > 0) {
+            std::memcpy(elements, other.elements, other.count * sizeof(T));
+        }
+        count = other.count;
+    }
+
+    // Heap buffers change hands; inline elements are copied
+    void takeFrom(SmallVector& other) noexcept {
+        if (other.isInline()) {
+            elements = inlineElements();
+            limit = N;
+            copyFrom(other);
+        } else {
+            elements = other.elements;
+            limit = other.limit;
+            count = other.count;
+            other.elements = other.inlineElements();
+            other.limit = N;
+        }
+        other.count = 0;
+    }
+
+    void release() noexcept {
+        if (!isInline()) {
+            ::operator delete(elements, std::align_val_t{alignof(T)});
+        }
+        elements = inlineElements();
+        limit = N;
+    }
+};
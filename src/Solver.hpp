@@ -0,0 +1,666 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "Board.hpp"
+#include "Game.hpp"
+#include "SearchStats.hpp"
+#include "Symmetry.hpp"
+#include "Tablebase.hpp"
+#include "ThreadPool.hpp"
+#include "TranspositionTable.hpp"
+
+// Budget for one search; a zero time or node limit means unlimited
+struct SearchLimits {
+    int maxDepth{std::numeric_limits<int>::max()};
+    std::chrono::milliseconds time{0};
+    unsigned long long nodes{0};
+};
+
+struct SearchResult {
+    uint16_t bestMove{TranspositionTable::NO_MOVE};
+    int score{0};
+    int depth{0};                   // Last fully completed iteration
+    unsigned long long nodes{0};    // Summed over all threads
+    std::chrono::microseconds time{0};
+    std::vector<uint16_t> pv;       // Principal variation starting with bestMove
+    std::vector<std::chrono::microseconds> depthTimes;  // Time at which each depth completed (index depth - 1)
+    std::vector<std::optional<int>> columnScores;       // Per column, filled by analyze(); nullopt when full
+    SearchStats stats;                                  // Counters summed over all threads
+};
+
+// Two-player negamax search, instantiated for Game and every FixedGame specialization.
+// search() runs iterative deepening with aspiration windows under a depth/time/node budget. It is a
+// Lazy SMP search: every thread deepens the same root on its own copy of the game and they cooperate
+// only through the shared lock-free transposition table. Positions are stored under their canonical
+// mirror key, and the root of a symmetric position searches only one column of every mirrored pair.
+// With an endgame tablebase set, every node with few enough empty cells is answered exactly.
+template<typename GameType>
+class Solver {
+private:
+    using BoardType = std::remove_cvref_t<decltype(std::declval<GameType>().board)>;
+    static constexpr bool fixedSize = !std::is_same_v<BoardType, Board>;
+
+    static constexpr int MAX_DEPTH = 8;
+    static constexpr int MAX_SEARCH_DEPTH = 128;
+    static constexpr int WIN_SCORE = 1000000;
+    static constexpr int TABLEBASE_WIN_SCORE = WIN_SCORE / 2;  // Proven win of unknown length, below every found win
+    static constexpr int INF = std::numeric_limits<int>::max();
+    static constexpr int ASPIRATION_WINDOW = 50;
+    static constexpr unsigned long long CHECK_INTERVAL = 1024;  // Nodes between budget checks
+
+    using Bound = TranspositionTable::Bound;
+    using Clock = std::chrono::steady_clock;
+
+    // State owned by one search thread, padded so counters of different threads never share a cache line.
+    // Buffers are sized once per search so the tree walk itself never allocates.
+    struct alignas(64) SearchThread {
+        GameType game;
+        bool isMain{false};
+        unsigned long long nodeCount{0};
+        std::vector<uint16_t> moveBuffer;                   // One width-sized slice per ply
+        std::vector<std::array<uint16_t, 2>> killers;       // Two cutoff moves per ply
+        std::vector<int> history;                           // Cutoff credit per (player, column)
+        std::vector<std::optional<int>> rootScores;         // Per column of the current iteration, when analyzing
+        SearchStats stats;
+
+        SearchThread(const GameType& game, const bool isMain)
+            : game(game)
+            , isMain(isMain)
+        {}
+    };
+
+    unsigned long long nodeCount{0};
+    unsigned threadCount;
+    std::atomic<bool> stopSearch{false};
+    std::atomic<unsigned long long> sharedNodes{0};
+    SearchLimits activeLimits;
+    Clock::time_point searchStart;
+    bool analyzing{false};  // Root moves get full windows so every column has an exact score
+    bool rootSymmetric{false};
+    const Tablebase* tablebase{nullptr};
+    bool tablebaseActive{false};  // The tablebase matches the board of the current search
+
+    TranspositionTable transpositionTable;
+
+    // Column ordering for better alpha-beta pruning, center-first (generated at compile time for fixed sizes)
+    std::vector<uint16_t> dynamicColumnOrder;
+
+    [[nodiscard]] std::span<const uint16_t> columnOrder() const noexcept {
+        if constexpr (fixedSize) {
+            return BoardType::columnOrder;
+        } else {
+            return dynamicColumnOrder;
+        }
+    }
+
+    // Table key shared with the mirror image; stored moves are in the key's orientation
+    [[nodiscard]] static CanonicalKey keyOf(const GameType& game) noexcept {
+        return canonicalKey(game);
+    }
+
+    // Evaluation weights, in the units of the leaf score
+    static constexpr int WINDOW_PAIR_WEIGHT = 2;    // Pair of own pieces in a window of four free of opponents
+    static constexpr int THREAT_WEIGHT = 16;        // Empty cell that completes four
+    static constexpr int PARITY_WEIGHT = 48;        // Extra for a threat on a row zugzwang hands to its owner
+    static constexpr int FORCED_LOSS_SCORE = 5000;  // Two playable opponent threats, only one can be blocked
+
+    // Both players' 64-bit boards side by side in one SIMD register (SSE2 on x86-64), lane 0 the side to
+    // move, so every mask operation of the evaluation serves both players at once
+    using MaskPair = uint64_t __attribute__((vector_size(16)));
+    using CountPair = int __attribute__((vector_size(8)));
+
+    template<typename Mask>
+    static constexpr unsigned laneBits = std::is_same_v<Mask, MaskPair> ? 64 : sizeof(Mask) * 8;
+
+    template<typename Mask>
+    [[nodiscard]] static int popcount(const Mask mask) noexcept {
+        if constexpr (sizeof(Mask) > sizeof(uint64_t)) {
+            return std::popcount(static_cast<uint64_t>(mask)) + std::popcount(static_cast<uint64_t>(mask >> 64));
+        } else {
+            return std::popcount(mask);
+        }
+    }
+
+    [[nodiscard]] static CountPair popcount(const MaskPair masks) noexcept {
+        return CountPair{std::popcount(masks[0]), std::popcount(masks[1])};
+    }
+
+    // Full adder on every bit: a + b + c = sum + 2 * carry
+    template<typename Mask>
+    static void carrySave(const Mask a, const Mask b, const Mask c, Mask& sum, Mask& carry) noexcept {
+        const Mask partial = a ^ b;
+        sum = partial ^ c;
+        carry = (a & b) | (partial & c);
+    }
+
+    // Windows of four cells along one direction (shift bits between neighbouring cells), every starting
+    // bit at once. A window counts when it is free of opponent pieces. Bit-sliced: (a, x) and (b, y) are
+    // the carry and sum bits of its first and second pair of cells, so it holds 2 * atLeastTwo + odd own
+    // pieces (four never occurs at a leaf). Cells of windows holding three are collected in covered; the
+    // empty ones among them are threat cells.
+    template<typename Mask>
+    static void scanWindows(const Mask own, const Mask free, const unsigned shift, Mask& atLeastTwo, Mask& three,
+                            Mask& covered) noexcept {
+        // A window this long in this direction cannot fit the board (and the shift would overflow)
+        if (3 * shift >= laneBits<Mask>) {
+            atLeastTwo = three = Mask{};
+            return;
+        }
+        const Mask freePairs = free & (free >> shift);
+        const Mask starts = freePairs & (freePairs >> 2 * shift);
+        const Mask a = own & (own >> shift), x = own ^ (own >> shift);
+        const Mask b = a >> 2 * shift, y = x >> 2 * shift;
+        atLeastTwo = starts & (a | b | (x & y));
+        three = atLeastTwo & (x ^ y);
+        const Mask threePairs = three | (three << shift);
+        covered |= threePairs | (threePairs << 2 * shift);
+    }
+
+    // Every window of four free of opponent pieces, worth the number of pairs of own pieces it holds (1 with
+    // two pieces, 3 with three); fills threats with the empty cells that complete four. Carry-save adders
+    // sum the eight window masks bit by bit first, leaving four popcounts instead of eight.
+    template<typename Mask>
+    [[nodiscard]] static auto scoreWindows(const Mask own, const Mask free, const unsigned height,
+                                           Mask& threats) noexcept {
+        std::array<Mask, 4> atLeastTwo, three;
+        threats = Mask{};
+        scanWindows(own, free, 1, atLeastTwo[0], three[0], threats);
+        scanWindows(own, free, height + 1, atLeastTwo[1], three[1], threats);
+        scanWindows(own, free, height, atLeastTwo[2], three[2], threats);
+        scanWindows(own, free, height + 2, atLeastTwo[3], three[3], threats);
+        threats &= free & ~own;
+
+        // atLeastTwo weighs 1 and three 2 more
+        Mask ones, twos, fours, eights, sum1, sum2, carry1, carry2, carry3;
+        carrySave(atLeastTwo[0], atLeastTwo[1], atLeastTwo[2], sum1, carry1);
+        ones = sum1 ^ atLeastTwo[3];
+        carry2 = sum1 & atLeastTwo[3];
+        carrySave(carry1, carry2, three[0], sum1, carry1);
+        carrySave(three[1], three[2], three[3], sum2, carry2);
+        twos = sum1 ^ sum2;
+        carry3 = sum1 & sum2;
+        carrySave(carry1, carry2, carry3, fours, eights);
+        return WINDOW_PAIR_WEIGHT * (popcount(ones) + 2 * popcount(twos) + 4 * popcount(fours) + 8 * popcount(eights));
+    }
+
+    // Threat evaluation of a bitboard position for the side owning own: every window of four, then every
+    // threat cell of either side. On boards of even height a threat of the first player on an odd row
+    // (counted from 1 at the bottom) or of the second player on an even row counts extra, as the
+    // column-filling endgame hands exactly those cells to their owner.
+    template<typename Mask>
+    [[nodiscard]] static int scoreBitboards(const Mask own, const Mask opponent, const Mask bottom,
+                                            const unsigned height, const bool ownMovesFirst) noexcept {
+        const Mask boardMask = bottom * ((Mask{1} << height) - 1);
+
+        Mask ownThreats, opponentThreats;
+        int score;
+        if constexpr (sizeof(Mask) == sizeof(uint64_t)) {
+            MaskPair threats;
+            const MaskPair free{boardMask & ~opponent, boardMask & ~own};
+            const auto windows = scoreWindows(MaskPair{own, opponent}, free, height, threats);
+            const auto threatCounts = popcount(threats);
+            score = windows[0] - windows[1] + THREAT_WEIGHT * (threatCounts[0] - threatCounts[1]);
+            ownThreats = threats[0];
+            opponentThreats = threats[1];
+        } else {
+            score = scoreWindows(own, boardMask & ~opponent, height, ownThreats) -
+                    scoreWindows(opponent, boardMask & ~own, height, opponentThreats);
+            score += THREAT_WEIGHT * (popcount(ownThreats) - popcount(opponentThreats));
+        }
+
+        const Mask forcedThreats = opponentThreats & ((own | opponent) + bottom);
+        if (forcedThreats & (forcedThreats - 1)) {
+            return -FORCED_LOSS_SCORE;
+        }
+        if (height % 2 == 0) {
+            const Mask oddRows = bottom * static_cast<Mask>(0x5555555555555555ull & ((uint64_t{1} << height) - 1));
+            const Mask ownRows = ownMovesFirst ? oddRows : boardMask & ~oddRows;
+            score += PARITY_WEIGHT * (popcount(ownThreats & ownRows) - popcount(opponentThreats & ~ownRows));
+        }
+        return score;
+    }
+
+    // Leaf score for the side to move; the search has already ruled out an immediate win
+    int evaluatePosition(const GameType& game) const {
+        const auto& board = game.board;
+        const auto own = static_cast<std::size_t>(game.currentPlayer - 1);
+        const bool ownMovesFirst = game.currentPlayer == 1;
+
+        if constexpr (fixedSize) {
+            const auto& masks = board.bitboardMasks();
+            return scoreBitboards(masks[own], masks[1 - own], BoardType::bottomMask, BoardType::height, ownMovesFirst);
+        } else {
+            if (board.usesBitboard()) {
+                const auto bottom = board.bottomMask;
+                const auto& masks = board.bitboardMasks();
+                // Vector shifts by a variable count cost twice as much, so common heights get constant ones
+                switch (board.height) {
+                    case 5: return scoreBitboards(masks[own], masks[1 - own], bottom, 5u, ownMovesFirst);
+                    case 6: return scoreBitboards(masks[own], masks[1 - own], bottom, 6u, ownMovesFirst);
+                    case 7: return scoreBitboards(masks[own], masks[1 - own], bottom, 7u, ownMovesFirst);
+                    case 8: return scoreBitboards(masks[own], masks[1 - own], bottom, 8u, ownMovesFirst);
+                    default: return scoreBitboards(masks[own], masks[1 - own], bottom, board.height, ownMovesFirst);
+                }
+            }
+
+            // Boards too large for a bitboard: center control and playable threats, answered by the
+            // backend's win checks
+            const uint16_t centerCol = board.width / 2;
+            int score = board.heights[centerCol] * 3;
+            if (centerCol > 0) score += board.heights[centerCol - 1] * 2;
+            if (centerCol + 1 < board.width) score += board.heights[centerCol + 1] * 2;
+            const auto opponent = static_cast<uint8_t>(3 - game.currentPlayer);
+            return score + 100 * (board.countWinningMoves(game.currentPlayer) - board.countWinningMoves(opponent));
+        }
+    }
+
+    // Sets the stop flag once the time or node budget is spent; called by the main thread only
+    void checkLimits() noexcept {
+        if (activeLimits.nodes != 0 && sharedNodes.load(std::memory_order_relaxed) >= activeLimits.nodes) {
+            stopSearch.store(true, std::memory_order_relaxed);
+        }
+        if (activeLimits.time.count() != 0 && Clock::now() - searchStart >= activeLimits.time) {
+            stopSearch.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]] bool stopped() const noexcept {
+        return stopSearch.load(std::memory_order_relaxed);
+    }
+
+    // Fills the ply's slice of the move buffer with legal columns: TT/PV move first, then killers,
+    // then the rest by history score, ties broken by center-first order
+    std::span<uint16_t> orderMoves(SearchThread& thread, const int ply, const uint16_t ttMove) {
+        const auto& game = thread.game;
+        const auto width = game.board.width;
+        const std::span<uint16_t> moves(thread.moveBuffer.data() + static_cast<std::size_t>(ply) * width, width);
+        const auto& killers = thread.killers[ply];
+        const auto* history = thread.history.data() + static_cast<std::size_t>(game.currentPlayer - 1) * width;
+
+        const auto priority = [&](const uint16_t col) {
+            if (col == ttMove) return INF;
+            if (col == killers[0]) return INF - 1;
+            if (col == killers[1]) return INF - 2;
+            return history[col];
+        };
+
+        std::size_t count = 0;
+        for (const uint16_t col : columnOrder()) {
+            if (!game.board.canPlace(col) || (ply == 0 && rootSymmetric && isMirroredColumn(col, width))) continue;
+            // Insertion sort keeps the center-first order among equal priorities
+            const auto value = priority(col);
+            auto pos = count++;
+            while (pos > 0 && priority(moves[pos - 1]) < value) {
+                moves[pos] = moves[pos - 1];
+                --pos;
+            }
+            moves[pos] = col;
+        }
+        return moves.first(count);
+    }
+
+    static void recordCutoff(SearchThread& thread, const int ply, const uint16_t col, const int depth) {
+        auto& killers = thread.killers[ply];
+        if (killers[0] != col) {
+            killers[1] = killers[0];
+            killers[0] = col;
+        }
+        const auto width = thread.game.board.width;
+        thread.history[static_cast<std::size_t>(thread.game.currentPlayer - 1) * width + col] += depth * depth;
+    }
+
+    // Walks the tree in place: every child is played and taken back on the thread's game.
+    // Once the search is stopped every node returns immediately and nothing more is stored.
+    int negamax(SearchThread& thread, int depth, const int ply, int alpha, int beta) {
+        auto& game = thread.game;
+        if (++thread.nodeCount % CHECK_INTERVAL == 0) {
+            sharedNodes.fetch_add(CHECK_INTERVAL, std::memory_order_relaxed);
+            if (thread.isMain) checkLimits();
+        }
+        if (stopped()) {
+            return 0;
+        }
+
+        // Transposition table lookup
+        const auto key = keyOf(game);
+        uint16_t ttMove = TranspositionTable::NO_MOVE;
+        countStat(thread.stats.ttProbes);
+        if (const auto entry = transpositionTable.probe(key.key)) {
+            countStat(thread.stats.ttHits);
+            ttMove = key.orient(entry->bestMove, game.board.width);
+            if (entry->depth >= depth) {
+                switch (entry->bound) {
+                    case Bound::EXACT:
+                        countStat(thread.stats.ttCutoffs);
+                        return entry->score;
+                    case Bound::LOWER:
+                        alpha = std::max(alpha, entry->score);
+                        break;
+                    case Bound::UPPER:
+                        beta = std::min(beta, entry->score);
+                        break;
+                    case Bound::NONE:
+                        break;
+                }
+                if (alpha >= beta) {
+                    countStat(thread.stats.ttCutoffs);
+                    return entry->score;
+                }
+            }
+        }
+
+        // Check for immediate win using pre-ordered columns
+        for (uint16_t col : columnOrder()) {
+            if (game.isWinningMove(col)) {
+                return WIN_SCORE * (depth + 1);
+            }
+        }
+
+        // Exact result once few enough cells are empty for the endgame tablebase
+        if (tablebaseActive) {
+            if (const auto outcome = tablebase->probe(key.key, game.board.maxMoves - game.board.movesPlayed)) {
+                countStat(thread.stats.tablebaseHits);
+                return *outcome == TablebaseOutcome::WIN ? TABLEBASE_WIN_SCORE
+                     : *outcome == TablebaseOutcome::LOSS ? -TABLEBASE_WIN_SCORE : 0;
+            }
+        }
+
+        // Base cases
+        if (depth == 0 || game.board.movesPlayed >= game.board.maxMoves ||
+            ply + 1 >= static_cast<int>(thread.killers.size())) {
+            return evaluatePosition(game);
+        }
+
+        int bestScore = -INF;
+        uint16_t bestMove = TranspositionTable::NO_MOVE;
+        auto entryType = Bound::UPPER;
+        unsigned movesSearched = 0;
+
+        for (const uint16_t col : orderMoves(thread, ply, ttMove)) {
+            ++movesSearched;
+            (void)game.place(col);
+            const int score = -negamax(thread, depth - 1, ply + 1, -beta, -alpha);
+            game.unplace(col);
+            if (stopped()) {
+                return 0;
+            }
+            if (score > bestScore) {
+                bestScore = score;
+                bestMove = col;
+                if (score > alpha) {
+                    alpha = score;
+                    entryType = Bound::EXACT;
+                    if (alpha >= beta) {
+                        entryType = Bound::LOWER;
+                        recordCutoff(thread, ply, col, depth);
+                        countStat(thread.stats.betaCutoffs);
+                        countStat(thread.stats.firstMoveCutoffs, movesSearched == 1);
+                        break;
+                    }
+                }
+            }
+        }
+
+        // Store position in transposition table
+        transpositionTable.store(key.key, bestScore, depth, entryType, key.orient(bestMove, game.board.width));
+        countStat(thread.stats.ttStores);
+        return bestScore;
+    }
+
+    struct RootResult {
+        int score;
+        uint16_t bestMove;
+    };
+
+    // Root of one iteration: like negamax but always reports which move produced the score.
+    // When analyzing, siblings never narrow each other's window and every score is recorded.
+    RootResult searchRoot(SearchThread& thread, const int depth, int alpha, const int beta, const uint16_t pvMove) {
+        auto& game = thread.game;
+        const int originalAlpha = alpha;
+        RootResult result{-INF, TranspositionTable::NO_MOVE};
+        std::ranges::fill(thread.rootScores, std::nullopt);
+
+        for (const uint16_t col : orderMoves(thread, 0, pvMove)) {
+            int score;
+            if (game.isWinningMove(col)) {
+                score = WIN_SCORE * (depth + 1);
+            } else {
+                (void)game.place(col);
+                score = analyzing ? -negamax(thread, depth - 1, 1, -INF, INF)
+                                  : -negamax(thread, depth - 1, 1, -beta, -alpha);
+                game.unplace(col);
+                if (stopped()) {
+                    break;
+                }
+            }
+            if (analyzing) {
+                thread.rootScores[col] = score;
+            }
+            if (score > result.score) {
+                result = {score, col};
+                alpha = std::max(alpha, score);
+                if (!analyzing && alpha >= beta) break;
+            }
+        }
+
+        // Skipped columns score the same as their mirror images
+        if (analyzing && rootSymmetric) {
+            const auto width = game.board.width;
+            for (uint16_t col = 0; col < width; ++col) {
+                if (isMirroredColumn(col, width)) thread.rootScores[col] = thread.rootScores[width - 1 - col];
+            }
+        }
+
+        if (!stopped() && result.bestMove != TranspositionTable::NO_MOVE) {
+            // A fail-low only bounds the score from above and its move was never shown to be best
+            const auto bound = result.score <= originalAlpha ? Bound::UPPER
+                             : result.score >= beta          ? Bound::LOWER
+                                                             : Bound::EXACT;
+            const auto move = bound == Bound::UPPER ? TranspositionTable::NO_MOVE : result.bestMove;
+            const auto key = keyOf(game);
+            transpositionTable.store(key.key, result.score, depth, bound, key.orient(move, game.board.width));
+        }
+        return result;
+    }
+
+    // Iterative deepening loop run by every thread; result is only written by the main thread
+    void iterativeDeepening(SearchThread& thread, const int startDepth, const int maxDepth, SearchResult* result) {
+        int previousScore = 0;
+        uint16_t pvMove = TranspositionTable::NO_MOVE;
+
+        for (int depth = startDepth; depth <= maxDepth && !stopped(); ++depth) {
+            const auto iterationStart = thread.nodeCount;
+            // Aspiration window around the previous score, re-searched with a full window on failure
+            const bool aspirate = depth > startDepth && !analyzing;
+            const int alpha = aspirate ? previousScore - ASPIRATION_WINDOW : -INF;
+            const int beta = aspirate ? previousScore + ASPIRATION_WINDOW : INF;
+            auto root = searchRoot(thread, depth, alpha, beta, pvMove);
+            if (!stopped() && (root.score <= alpha || root.score >= beta)) {
+                root = searchRoot(thread, depth, -INF, INF, root.bestMove);
+            }
+            if (stopped() || root.bestMove == TranspositionTable::NO_MOVE) {
+                break;
+            }
+
+            previousScore = root.score;
+            pvMove = root.bestMove;
+            if (result) {
+                result->bestMove = root.bestMove;
+                result->score = root.score;
+                result->depth = depth;
+                result->depthTimes.resize(depth, std::chrono::microseconds{0});
+                result->depthTimes[depth - 1] =
+                    std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - searchStart);
+                if (analyzing) result->columnScores = thread.rootScores;
+                if constexpr (SearchStats::enabled) {
+                    result->stats.iterations.push_back({depth, thread.nodeCount - iterationStart,
+                                                        result->depthTimes[depth - 1]});
+                }
+            }
+        }
+    }
+
+    // Follows best moves stored in the transposition table from the root
+    [[nodiscard]] std::vector<uint16_t> principalVariation(const GameType& root, const uint16_t bestMove,
+                                                           const int depth) const {
+        std::vector<uint16_t> pv;
+        pv.reserve(depth);
+        GameType game(root);
+        auto move = bestMove;
+        while (move != TranspositionTable::NO_MOVE && static_cast<int>(pv.size()) < depth &&
+               move < game.board.width && game.board.canPlace(move)) {
+            pv.push_back(move);
+            if (game.place(move)) break;
+            const auto key = keyOf(game);
+            const auto entry = transpositionTable.probe(key.key);
+            move = entry ? key.orient(entry->bestMove, game.board.width) : TranspositionTable::NO_MOVE;
+        }
+        return pv;
+    }
+
+    static void prepareThread(SearchThread& thread, const int maxPly) {
+        const auto width = thread.game.board.width;
+        thread.moveBuffer.assign(static_cast<std::size_t>(maxPly + 1) * width, 0);
+        thread.killers.assign(maxPly + 1, {TranspositionTable::NO_MOVE, TranspositionTable::NO_MOVE});
+        thread.history.assign(static_cast<std::size_t>(Board::MAX_PLAYERS) * width, 0);
+        thread.rootScores.assign(width, std::nullopt);
+    }
+
+public:
+    // The transposition table is allocated once up front; its size is the memory budget in MB
+    explicit Solver(const std::size_t hashSizeMB = TranspositionTable::DEFAULT_SIZE_MB,
+                    const unsigned threads = std::thread::hardware_concurrency())
+        : threadCount(std::max(1u, threads))
+        , transpositionTable(hashSizeMB)
+    {}
+
+    void setHashSize(const std::size_t megabytes) {
+        transpositionTable.resize(megabytes);
+    }
+
+    void setThreads(const unsigned threads) {
+        threadCount = std::max(1u, threads);
+    }
+
+    // Endgame tablebase probed inside the tree when its board size matches; nullptr disables it.
+    // The tablebase must outlive the searches.
+    void setTablebase(const Tablebase* table) noexcept {
+        tablebase = table;
+    }
+
+    // Aborts the running search from any thread; search() then returns the result of the last
+    // completed iteration
+    void stop() noexcept {
+        stopSearch.store(true, std::memory_order_relaxed);
+    }
+
+    // Forgets every stored position. Entries persist across moves and games and older generations are
+    // replaced first, so within one board size this only drops them eagerly. Keys leave out the board
+    // size, so a dynamic-size solver must be cleared before it searches a board of another shape.
+    void newGame() noexcept {
+        transpositionTable.clear();
+    }
+
+    SearchResult search(const GameType& game, const SearchLimits& limits) {
+        transpositionTable.newSearch();  // Age entries from earlier searches instead of clearing
+        if constexpr (!fixedSize) {
+            dynamicColumnOrder.resize(game.board.width);
+            centerFirstColumnOrder(dynamicColumnOrder);
+        }
+
+        activeLimits = limits;
+        searchStart = Clock::now();
+        stopSearch.store(false, std::memory_order_relaxed);
+        sharedNodes.store(0, std::memory_order_relaxed);
+        rootSymmetric = isMirrorSymmetric(game.board);
+        tablebaseActive = tablebase && tablebase->covers(game.board.width, game.board.height);
+
+        const int remaining = game.board.maxMoves - game.board.movesPlayed;
+        const int maxDepth = std::clamp(limits.maxDepth, 1, std::max(1, std::min(remaining, MAX_SEARCH_DEPTH)));
+
+        SearchResult result;
+        // Per-iteration records are sized once, so a deeper search allocates no more than a shallow one
+        result.depthTimes.reserve(maxDepth);
+        if constexpr (SearchStats::enabled) result.stats.iterations.reserve(maxDepth);
+        // A legal move to fall back on if the search is stopped before the first iteration completes
+        for (const uint16_t col : columnOrder()) {
+            if (game.board.canPlace(col)) {
+                result.bestMove = col;
+                break;
+            }
+        }
+        if (remaining <= 0) {
+            return result;
+        }
+
+        // Helpers alternate between starting at depth 1 and depth 2 and may go one ply deeper than the
+        // main thread, so threads desynchronize and fill the table with entries the main thread can cut on
+        // Lazy SMP needs every helper running alongside the main thread, so the pool is grown to fit
+        std::vector<unsigned long long> helperNodes(threadCount - 1, 0);
+        std::vector<SearchStats> helperStats(threadCount - 1);
+        ThreadPool::global().ensureWorkers(threadCount - 1);
+        TaskGroup helpers;
+        for (unsigned i = 0; i + 1 < threadCount; ++i) {
+            helpers.run([this, &game, &helperNodes, &helperStats, i, maxDepth] {
+                SearchThread thread(game, false);
+                prepareThread(thread, maxDepth + 1);
+                iterativeDeepening(thread, 1 + static_cast<int>(i % 2), maxDepth + 1, nullptr);
+                helperNodes[i] = thread.nodeCount;
+                helperStats[i] = std::move(thread.stats);
+            });
+        }
+
+        SearchThread mainThread(game, true);  // The only copy made by this thread during a search
+        prepareThread(mainThread, maxDepth + 1);
+        iterativeDeepening(mainThread, 1, maxDepth, &result);
+
+        stopSearch.store(true, std::memory_order_relaxed);
+        helpers.wait();
+
+        nodeCount = mainThread.nodeCount;
+        for (const auto nodes : helperNodes) nodeCount += nodes;
+        result.nodes = nodeCount;
+        result.stats.merge(mainThread.stats);
+        for (const auto& stats : helperStats) result.stats.merge(stats);
+        if constexpr (SearchStats::enabled) result.stats.nodes = nodeCount;
+        result.time = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - searchStart);
+        result.pv = principalVariation(game, result.bestMove, result.depth);
+        return result;
+    }
+
+    // Like search() but every playable column is scored exactly (result.columnScores) in the same
+    // search, sharing one table, instead of one search per child. No root move is cut, so it costs
+    // more than search() for the same depth.
+    SearchResult analyze(const GameType& game, const SearchLimits& limits) {
+        analyzing = true;
+        auto result = search(game, limits);
+        analyzing = false;
+        return result;
+    }
+
+    // Fixed-depth search returning the score of the side to move
+    int solve(const GameType& game, int depth = MAX_DEPTH) {
+        return search(game, {.maxDepth = depth}).score;
+    }
+
+    // Static evaluation from the side to move's point of view, the leaf score of the search
+    [[nodiscard]] int evaluate(const GameType& game) const {
+        return evaluatePosition(game);
+    }
+
+    // Nodes visited by all threads during the last search
+    [[nodiscard]] unsigned long long getNodeCount() const {
+        return nodeCount;
+    }
+};
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+
+#include "Zobrist.hpp"
+
+// Left-right reflection. A position and its mirror image are the same position for every purpose, so
+// caches and stored formats key both by one canonical key and keep moves in the canonical orientation.
+// Boards maintain the Zobrist key of their mirror image incrementally next to their own.
+
+// Key shared by a position and its mirror image; mirrored is set when the reflection was chosen
+struct CanonicalKey {
+    uint64_t key;
+    bool mirrored;
+
+    // Maps a column between the position and the canonical orientation (both ways, it is its own
+    // inverse); values outside the board such as NO_MOVE pass through
+    [[nodiscard]] uint16_t orient(const uint16_t col, const uint16_t width) const noexcept {
+        return mirrored && col < width ? static_cast<uint16_t>(width - 1 - col) : col;
+    }
+};
+
+template<typename BoardType>
+[[nodiscard]] CanonicalKey canonicalBoardKey(const BoardType& board, const uint64_t salt = 0) noexcept {
+    const auto hash = board.zobristHash();
+    const auto mirror = board.mirroredZobristHash();
+    return mirror < hash ? CanonicalKey{mirror ^ salt, true} : CanonicalKey{hash ^ salt, false};
+}
+
+// Canonical key of the position including the side to move
+template<typename GameType>
+[[nodiscard]] CanonicalKey canonicalKey(const GameType& game) noexcept {
+    return canonicalBoardKey(game.board, zobrist::sideKey(game.currentPlayer));
+}
+
+// True while the board equals its own mirror image, when the columns right of the center need no search
+template<typename BoardType>
+[[nodiscard]] bool isMirrorSymmetric(const BoardType& board) noexcept {
+    return board.zobristHash() == board.mirroredZobristHash();
+}
+
+// True for the columns a symmetric position leaves out: the right-hand one of every mirrored pair
+[[nodiscard]] constexpr bool isMirroredColumn(const uint16_t col, const uint16_t width) noexcept {
+    return col > width - 1 - col;
+}
@@ -0,0 +1,217 @@
+#include "Tablebase.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ThreadPool.hpp"
+#include "Zobrist.hpp"
+
+namespace {
+    constexpr double BITS_PER_KEY = 2.0;  // Level size over keys left; larger builds faster and uses more bits
+    constexpr uint64_t MAX_LEVELS = 32;
+    constexpr std::size_t BUILD_CHUNK = 1 << 16;
+
+    // Slot of a key in a level of bitCount bits, an independent hash per level
+    [[nodiscard]] uint64_t levelSlot(const uint64_t key, const uint64_t level, const uint64_t bitCount) noexcept {
+        const auto hash = zobrist::mix(key ^ ((level + 1) * 0x9E3779B97F4A7C15ull));
+        return static_cast<uint64_t>((static_cast<unsigned __int128>(hash) * bitCount) >> 64);
+    }
+
+    template<typename T>
+    void writeArray(std::ofstream& out, const std::span<const T> values) {
+        out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size_bytes()));
+    }
+
+    // Takes count elements of T off the front of a mapped region; false when the file is too short
+    template<typename T>
+    [[nodiscard]] bool takeArray(const std::byte*& position, const std::byte* end, const uint64_t count,
+                                 std::span<const T>& array) noexcept {
+        if (count > static_cast<uint64_t>(end - position) / sizeof(T)) return false;
+        array = {reinterpret_cast<const T*>(position), static_cast<std::size_t>(count)};
+        position += count * sizeof(T);
+        return true;
+    }
+}
+
+PerfectHash::Storage PerfectHash::build(const std::span<const uint64_t> keys) {
+    Storage storage;
+    std::vector<uint64_t> remaining(keys.begin(), keys.end());
+
+    for (uint64_t level = 0; level < MAX_LEVELS && !remaining.empty(); ++level) {
+        const auto slots = std::max<uint64_t>(64, static_cast<uint64_t>(static_cast<double>(remaining.size()) * BITS_PER_KEY));
+        const auto bitCount = (slots + 63) / 64 * 64;
+        std::vector<uint64_t> seen(bitCount / 64);
+        std::vector<uint64_t> collided(bitCount / 64);
+
+        const auto chunks = (remaining.size() + BUILD_CHUNK - 1) / BUILD_CHUNK;
+        parallelFor(0, chunks, [&](const std::size_t chunk) {
+            const auto last = std::min(remaining.size(), (chunk + 1) * BUILD_CHUNK);
+            for (auto i = chunk * BUILD_CHUNK; i < last; ++i) {
+                const auto slot = levelSlot(remaining[i], level, bitCount);
+                const auto mask = uint64_t{1} << (slot % 64);
+                if (std::atomic_ref(seen[slot / 64]).fetch_or(mask, std::memory_order_relaxed) & mask) {
+                    std::atomic_ref(collided[slot / 64]).fetch_or(mask, std::memory_order_relaxed);
+                }
+            }
+        });
+
+        storage.levels.push_back({storage.bits.size() * 64, bitCount});
+        for (std::size_t word = 0; word < seen.size(); ++word) {
+            storage.bits.push_back(seen[word] & ~collided[word]);
+        }
+        std::erase_if(remaining, [&](const uint64_t key) {
+            const auto slot = levelSlot(key, level, bitCount);
+            return (collided[slot / 64] >> (slot % 64) & 1) == 0;
+        });
+    }
+
+    uint64_t total = 0;
+    for (std::size_t word = 0; word < storage.bits.size(); ++word) {
+        if (word % 8 == 0) storage.ranks.push_back(total);
+        total += static_cast<uint64_t>(std::popcount(storage.bits[word]));
+    }
+    storage.ranks.push_back(total);
+
+    std::ranges::sort(remaining);
+    storage.fallback = std::move(remaining);
+    return storage;
+}
+
+uint64_t PerfectHash::operator()(const uint64_t key) const noexcept {
+    for (std::size_t level = 0; level < levels.size(); ++level) {
+        const auto bit = levels[level].bitOffset + levelSlot(key, level, levels[level].bitCount);
+        const auto word = bits[bit / 64];
+        const auto mask = uint64_t{1} << (bit % 64);
+        if (word & mask) {
+            auto rank = ranks[bit / 512];
+            for (auto before = bit / 512 * 8; before < bit / 64; ++before) {
+                rank += static_cast<uint64_t>(std::popcount(bits[before]));
+            }
+            return rank + static_cast<uint64_t>(std::popcount(word & (mask - 1)));
+        }
+    }
+    const auto it = std::ranges::lower_bound(fallback, key);
+    return (ranks.empty() ? 0 : ranks.back()) + static_cast<uint64_t>(it - fallback.begin());
+}
+
+Tablebase::~Tablebase() {
+    close();
+}
+
+std::expected<void, std::string> Tablebase::open(const std::string& path) {
+    close();
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return std::unexpected("Cannot open tablebase " + path);
+    }
+
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(Header)) {
+        ::close(fd);
+        return std::unexpected("Tablebase is truncated");
+    }
+
+    const auto fileSize = static_cast<std::size_t>(info.st_size);
+    void* data = ::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping stays valid after the descriptor is closed
+    if (data == MAP_FAILED) {
+        return std::unexpected("Failed to map tablebase");
+    }
+
+    const auto* fileHeader = static_cast<const Header*>(data);
+    const auto* position = static_cast<const std::byte*>(data) + sizeof(Header);
+    const auto* end = static_cast<const std::byte*>(data) + fileSize;
+    std::span<const LayerHeader> layerHeaders;
+    bool valid = std::memcmp(fileHeader->magic, MAGIC, sizeof(MAGIC)) == 0 &&
+                 fileHeader->maxEmpty <= static_cast<uint32_t>(fileHeader->width) * fileHeader->height &&
+                 takeArray(position, end, fileHeader->maxEmpty + 1ull, layerHeaders);
+
+    std::vector<MappedLayer> mappedLayers;
+    uint64_t positions = 0;
+    for (std::size_t i = 0; valid && i < layerHeaders.size(); ++i) {
+        const auto& layer = layerHeaders[i];
+        std::span<const PerfectHash::Level> levels;
+        std::span<const uint64_t> bits, ranks, fallback, values;
+        valid = takeArray(position, end, layer.levelCount, levels) && takeArray(position, end, layer.bitWords, bits) &&
+                takeArray(position, end, layer.rankCount, ranks) && takeArray(position, end, layer.fallbackCount, fallback) &&
+                takeArray(position, end, layer.valueWords, values) &&
+                layer.rankCount == (layer.bitWords + 7) / 8 + 1 && layer.valueWords == (layer.positionCount + 31) / 32 &&
+                ranks.back() + layer.fallbackCount == layer.positionCount &&
+                std::ranges::all_of(levels, [&](const PerfectHash::Level& level) {
+                    return level.bitCount % 64 == 0 && level.bitOffset % 64 == 0 &&
+                           level.bitOffset / 64 + level.bitCount / 64 <= layer.bitWords;
+                });
+        if (valid) {
+            mappedLayers.push_back({PerfectHash(levels, bits, ranks, fallback), values});
+            positions += layer.positionCount;
+        }
+    }
+    if (!valid || position != end || positions != fileHeader->positionCount) {
+        ::munmap(data, fileSize);
+        return std::unexpected("Not a valid tablebase");
+    }
+
+    mapping = data;
+    mappingSize = fileSize;
+    header = fileHeader;
+    layers = std::move(mappedLayers);
+    return {};
+}
+
+void Tablebase::close() noexcept {
+    if (mapping) {
+        ::munmap(mapping, mappingSize);
+    }
+    mapping = nullptr;
+    mappingSize = 0;
+    header = nullptr;
+    layers.clear();
+}
+
+std::expected<void, std::string>
+Tablebase::write(const std::string& path, const uint16_t width, const uint16_t height, const std::span<const Layer> layers) {
+    if (layers.empty()) {
+        return std::unexpected("A tablebase needs at least the full-board layer");
+    }
+
+    Header fileHeader{};
+    std::memcpy(fileHeader.magic, MAGIC, sizeof(MAGIC));
+    fileHeader.width = width;
+    fileHeader.height = height;
+    fileHeader.maxEmpty = static_cast<uint16_t>(layers.size() - 1);
+
+    std::vector<LayerHeader> layerHeaders;
+    for (const auto& layer : layers) {
+        layerHeaders.push_back({layer.positionCount, layer.hash.levels.size(), layer.hash.bits.size(),
+                                layer.hash.ranks.size(), layer.hash.fallback.size(), layer.values.size()});
+        fileHeader.positionCount += layer.positionCount;
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return std::unexpected("Cannot create tablebase " + path);
+    }
+
+    out.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+    writeArray(out, std::span<const LayerHeader>(layerHeaders));
+    for (const auto& layer : layers) {
+        writeArray(out, std::span<const PerfectHash::Level>(layer.hash.levels));
+        writeArray(out, std::span<const uint64_t>(layer.hash.bits));
+        writeArray(out, std::span<const uint64_t>(layer.hash.ranks));
+        writeArray(out, std::span<const uint64_t>(layer.hash.fallback));
+        writeArray(out, std::span<const uint64_t>(layer.values));
+    }
+
+    if (!out) {
+        return std::unexpected("Failed to write tablebase " + path);
+    }
+    return {};
+}
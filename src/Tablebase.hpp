@@ -0,0 +1,163 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Symmetry.hpp"
+
+// Exact game-theoretic result of a position for the side to move
+enum class TablebaseOutcome : uint8_t { DRAW = 0, WIN = 1, LOSS = 2 };
+
+// Minimal perfect hash over a fixed set of distinct 64-bit keys (BBHash layout): every level is a bit
+// array with one bit per key that landed alone in its slot, colliding keys move on to the next level and
+// the few left after the last level are kept in a sorted list. A key's index is the rank of its bit, so
+// the structure costs about 3.7 bits per key and stores no keys. Keys outside the set map to an
+// arbitrary index.
+class PerfectHash {
+public:
+    struct Level {
+        uint64_t bitOffset;
+        uint64_t bitCount;
+    };
+
+    // Built structure; a PerfectHash either views one of these or the same arrays in a mapped file
+    struct Storage {
+        std::vector<Level> levels;
+        std::vector<uint64_t> bits;
+        std::vector<uint64_t> ranks;     // Set bits before every 512-bit block, plus the total
+        std::vector<uint64_t> fallback;  // Sorted keys that collided on every level
+    };
+
+    // Builds on all cores; keys must be distinct
+    [[nodiscard]] static Storage build(std::span<const uint64_t> keys);
+
+    PerfectHash() = default;
+    explicit PerfectHash(const Storage& storage) noexcept
+        : PerfectHash(storage.levels, storage.bits, storage.ranks, storage.fallback)
+    {}
+    PerfectHash(const std::span<const Level> levels, const std::span<const uint64_t> bits,
+                const std::span<const uint64_t> ranks, const std::span<const uint64_t> fallback) noexcept
+        : levels(levels)
+        , bits(bits)
+        , ranks(ranks)
+        , fallback(fallback)
+    {}
+
+    // Index in [0, size()) of a key of the set
+    [[nodiscard]] uint64_t operator()(uint64_t key) const noexcept;
+
+    [[nodiscard]] uint64_t size() const noexcept {
+        return (ranks.empty() ? 0 : ranks.back()) + fallback.size();
+    }
+
+private:
+    std::span<const Level> levels;
+    std::span<const uint64_t> bits;
+    std::span<const uint64_t> ranks;
+    std::span<const uint64_t> fallback;
+};
+
+// Read-only endgame tablebase memory-mapped from a file written by ConnectFourTablebase. It holds the
+// exact outcome of every position of one board size with up to maxEmpty() empty cells, 2 bits per
+// position indexed by a perfect hash of the canonical key, one layer per number of empty cells.
+// File layout: Header, maxEmpty + 1 LayerHeaders, then per layer its Levels, hash bits, ranks,
+// fallback keys and packed outcomes, all in 64-bit words.
+//
+// Only positions the search can reach may be probed: no four in a row yet and player 1 to move after
+// an even number of moves. Any other key reads an arbitrary stored outcome.
+class Tablebase {
+public:
+    static constexpr char MAGIC[8] = {'C', '4', 'T', 'B', 'A', 'S', 'E', '1'};
+
+    struct Header {
+        char magic[8];
+        uint16_t width;
+        uint16_t height;
+        uint16_t maxEmpty;
+        uint16_t reserved;
+        uint64_t positionCount;
+        uint64_t padding;
+    };
+    static_assert(sizeof(Header) == 32);
+
+    // Sizes of one layer's arrays, in elements
+    struct LayerHeader {
+        uint64_t positionCount;
+        uint64_t levelCount;
+        uint64_t bitWords;
+        uint64_t rankCount;
+        uint64_t fallbackCount;
+        uint64_t valueWords;
+    };
+    static_assert(sizeof(LayerHeader) == 48);
+
+    // Positions with the same number of empty cells; values packs 32 outcomes per word by hash index
+    struct Layer {
+        PerfectHash::Storage hash;
+        std::vector<uint64_t> values;
+        uint64_t positionCount{0};
+
+        [[nodiscard]] static TablebaseOutcome outcomeAt(std::span<const uint64_t> values, uint64_t index) noexcept {
+            return static_cast<TablebaseOutcome>((values[index / 32] >> (index % 32 * 2)) & 3);
+        }
+    };
+
+    Tablebase() = default;
+    ~Tablebase();
+
+    Tablebase(const Tablebase&) = delete;
+    Tablebase& operator=(const Tablebase&) = delete;
+
+    [[nodiscard]] std::expected<void, std::string> open(const std::string& path);
+    void close() noexcept;
+
+    [[nodiscard]] bool isOpen() const noexcept {
+        return header != nullptr;
+    }
+
+    [[nodiscard]] uint16_t maxEmpty() const noexcept {
+        return isOpen() ? header->maxEmpty : 0;
+    }
+
+    [[nodiscard]] uint64_t size() const noexcept {
+        return isOpen() ? header->positionCount : 0;
+    }
+
+    // True when positions of this board size can be probed once few enough cells are empty
+    [[nodiscard]] bool covers(const uint16_t width, const uint16_t height) const noexcept {
+        return isOpen() && header->width == width && header->height == height;
+    }
+
+    // Outcome for a canonicalKey() with emptyCells empty cells; nothing when the layer is not stored
+    [[nodiscard]] std::optional<TablebaseOutcome> probe(const uint64_t key, const uint32_t emptyCells) const noexcept {
+        if (emptyCells >= layers.size()) return std::nullopt;
+        const auto& layer = layers[emptyCells];
+        if (layer.values.empty()) return std::nullopt;
+        return Layer::outcomeAt(layer.values, layer.hash(key));
+    }
+
+    template<typename GameType>
+    [[nodiscard]] std::optional<TablebaseOutcome> probe(const GameType& game) const noexcept {
+        if (!covers(game.board.width, game.board.height)) return std::nullopt;
+        return probe(canonicalKey(game).key, game.board.maxMoves - game.board.movesPlayed);
+    }
+
+    // Writes a tablebase file; layers[e] holds the positions with e empty cells
+    [[nodiscard]] static std::expected<void, std::string>
+    write(const std::string& path, uint16_t width, uint16_t height, std::span<const Layer> layers);
+
+private:
+    struct MappedLayer {
+        PerfectHash hash;
+        std::span<const uint64_t> values;
+    };
+
+    const Header* header{nullptr};
+    std::vector<MappedLayer> layers;
+    void* mapping{nullptr};
+    std::size_t mappingSize{0};
+};
@@ -0,0 +1,293 @@
+// Offline endgame tablebase generator: enumerates every position of one board size with up to N empty
+// cells (no four in a row, mirror images folded) and solves them by retrograde analysis on all cores,
+// layer by layer from the full board backwards, so every position only looks up its children in the
+// layer solved before it. Writes a tablebase that the search probes once few enough cells are empty.
+// Positions are held in memory while their layer is solved (24 bytes each) and counts roughly double
+// per empty cell: 5x4 and 6x4 are solved whole within seconds, 6x5 up to 4 empty cells takes 133 million
+// positions, and the full-board layer of 7x6 alone does not fit in memory.
+//
+// Usage: ConnectFourTablebase <output> [--empty N] [--width W] [--height H]
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Board.hpp"
+#include "Tablebase.hpp"
+#include "ThreadPool.hpp"
+#include "Zobrist.hpp"
+
+namespace {
+    constexpr unsigned PREFIX_CELLS = 8;  // Colors of the first cells fixed per task, 2^8 tasks per height profile
+    constexpr std::size_t SOLVE_CHUNK = 4096;
+
+    struct Options {
+        std::string output;
+        uint16_t empty{4};
+        uint16_t width{6};
+        uint16_t height{5};
+    };
+
+    // Position as two column-major bitboards with a sentinel bit on top of every column
+    struct Position {
+        uint64_t player1;
+        uint64_t occupied;
+    };
+
+    struct Cell {
+        uint64_t bit;
+        uint32_t index;        // Zobrist cell index, col * height + row
+        uint32_t mirrorIndex;  // Same cell of the mirror image
+    };
+
+    class Generator {
+    public:
+        Generator(const uint16_t width, const uint16_t height)
+            : width(width)
+            , height(height)
+            , cells(static_cast<uint32_t>(width) * height)
+        {}
+
+        // Solves the layers with 0..maxEmpty empty cells, each from the one before
+        [[nodiscard]] std::vector<Tablebase::Layer> solve(const uint16_t maxEmpty) {
+            std::vector<Tablebase::Layer> layers;
+            for (uint32_t empty = 0; empty <= maxEmpty; ++empty) {
+                const auto start = std::chrono::steady_clock::now();
+                std::vector<Position> positions;
+                std::vector<uint64_t> keys;
+                enumerate(cells - empty, positions, keys);
+
+                Tablebase::Layer layer;
+                layer.positionCount = positions.size();
+                layer.hash = PerfectHash::build(keys);
+                layer.values.assign((positions.size() + 31) / 32, 0);
+                const auto counts = solveLayer(positions, keys, layer, layers.empty() ? nullptr : &layers.back());
+
+                const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+                std::println("{} empty: {} positions ({} wins, {} draws, {} losses) in {:.2f} seconds", empty,
+                             positions.size(), counts[1], counts[0], counts[2], duration.count());
+                layers.push_back(std::move(layer));
+            }
+            return layers;
+        }
+
+    private:
+        uint16_t width;
+        uint16_t height;
+        uint32_t cells;
+
+        [[nodiscard]] uint64_t columnBottom(const uint16_t col) const noexcept {
+            return uint64_t{1} << (col * (height + 1));
+        }
+
+        [[nodiscard]] uint64_t columnMask(const uint16_t col) const noexcept {
+            return ((uint64_t{1} << height) - 1) << (col * (height + 1));
+        }
+
+        [[nodiscard]] bool hasFour(const uint64_t pieces) const noexcept {
+            return Board::hasFourInMask(pieces, height);
+        }
+
+        // Raw Zobrist hash of the position and of its mirror image
+        [[nodiscard]] std::pair<uint64_t, uint64_t> hashes(const Position& position) const noexcept {
+            uint64_t hash = 0;
+            uint64_t mirror = 0;
+            for (uint16_t col = 0; col < width; ++col) {
+                auto pieces = (position.occupied & columnMask(col)) >> (col * (height + 1));
+                const auto player1 = (position.player1 & columnMask(col)) >> (col * (height + 1));
+                for (uint32_t row = 0; pieces; ++row, pieces >>= 1) {
+                    const uint8_t player = (player1 >> row & 1) ? 1 : 2;
+                    hash ^= zobrist::pieceKey(col * height + row, player);
+                    mirror ^= zobrist::pieceKey((width - 1 - col) * height + row, player);
+                }
+            }
+            return {hash, mirror};
+        }
+
+        // Every gravity-consistent coloring of pieces cells without a four in a row, one orientation of
+        // each mirrored pair, with canonicalKey() of each position
+        void enumerate(const uint32_t pieces, std::vector<Position>& positions, std::vector<uint64_t>& keys) const {
+            std::vector<std::vector<Cell>> profiles;
+            std::vector<uint16_t> heights(width);
+            collectProfiles(0, pieces, heights, profiles);
+
+            const auto prefixCells = std::min(pieces, PREFIX_CELLS);
+            const auto prefixes = std::size_t{1} << prefixCells;
+            std::vector<std::vector<Position>> taskPositions(profiles.size() * prefixes);
+            std::vector<std::vector<uint64_t>> taskKeys(taskPositions.size());
+            parallelFor(0, taskPositions.size(), [&](const std::size_t task) {
+                Walk walk{*this, profiles[task / prefixes], task % prefixes, prefixCells, (pieces + 1) / 2, pieces / 2,
+                          zobrist::sideKey(pieces % 2 == 0 ? 1 : 2), taskPositions[task], taskKeys[task]};
+                walk.visit(0, 0, 0, 0, 0);
+            });
+
+            for (std::size_t task = 0; task < taskPositions.size(); ++task) {
+                positions.insert(positions.end(), taskPositions[task].begin(), taskPositions[task].end());
+                keys.insert(keys.end(), taskKeys[task].begin(), taskKeys[task].end());
+                taskPositions[task] = {};
+                taskKeys[task] = {};
+            }
+        }
+
+        // Column heights summing to the piece count, each as its cells in column-major order
+        void collectProfiles(const uint16_t col, const uint32_t remaining, std::vector<uint16_t>& heights,
+                             std::vector<std::vector<Cell>>& profiles) const {
+            if (col == width) {
+                if (remaining > 0) return;
+                auto& profile = profiles.emplace_back();
+                for (uint16_t c = 0; c < width; ++c) {
+                    for (uint32_t row = 0; row < heights[c]; ++row) {
+                        profile.push_back({columnBottom(c) << row, c * height + row, (width - 1 - c) * height + row});
+                    }
+                }
+                return;
+            }
+            if (remaining > static_cast<uint32_t>(width - col) * height) return;
+            for (uint16_t h = 0; h <= std::min<uint32_t>(height, remaining); ++h) {
+                heights[col] = h;
+                collectProfiles(static_cast<uint16_t>(col + 1), remaining - h, heights, profiles);
+            }
+        }
+
+        // Depth-first coloring of one height profile with the colors of the first cells fixed by prefix
+        struct Walk {
+            const Generator& generator;
+            const std::vector<Cell>& cells;
+            std::size_t prefix;
+            uint32_t prefixCells;
+            uint32_t player1Pieces;
+            uint32_t player2Pieces;
+            uint64_t side;
+            std::vector<Position>& positions;
+            std::vector<uint64_t>& keys;
+
+            void visit(const std::size_t index, const uint64_t player1, const uint64_t player2, const uint64_t hash,
+                       const uint64_t mirror) {
+                if (index == cells.size()) {
+                    // Keep the orientation with the smaller key; a symmetric position is its own mirror image
+                    if (hash <= mirror) {
+                        positions.push_back({player1, player1 | player2});
+                        keys.push_back(hash ^ side);
+                    }
+                    return;
+                }
+
+                const auto& cell = cells[index];
+                const auto placed1 = static_cast<uint32_t>(std::popcount(player1));
+                const auto placed2 = static_cast<uint32_t>(index) - placed1;
+                for (const uint8_t player : {uint8_t{1}, uint8_t{2}}) {
+                    if (index < prefixCells && (prefix >> index & 1) != player - 1u) continue;
+                    if (player == 1 ? placed1 == player1Pieces : placed2 == player2Pieces) continue;
+                    const auto mine = (player == 1 ? player1 : player2) | cell.bit;
+                    if (generator.hasFour(mine)) continue;
+                    visit(index + 1, player == 1 ? mine : player1, player == 1 ? player2 : mine,
+                          hash ^ zobrist::pieceKey(cell.index, player), mirror ^ zobrist::pieceKey(cell.mirrorIndex, player));
+                }
+            }
+        };
+
+        // Outcome of every position from its children in the previous layer: a win when a move completes
+        // four or leaves the opponent lost, a draw when some move keeps a draw, a loss otherwise
+        [[nodiscard]] std::array<uint64_t, 3> solveLayer(const std::vector<Position>& positions,
+                                                         const std::vector<uint64_t>& keys, Tablebase::Layer& layer,
+                                                         const Tablebase::Layer* previous) const {
+            const PerfectHash hash(layer.hash);
+            const PerfectHash childHash = previous ? PerfectHash(previous->hash) : PerfectHash();
+            std::array<std::atomic<uint64_t>, 3> counts{};
+
+            const auto chunks = (positions.size() + SOLVE_CHUNK - 1) / SOLVE_CHUNK;
+            parallelFor(0, chunks, [&](const std::size_t chunk) {
+                std::array<uint64_t, 3> chunkCounts{};
+                const auto last = std::min(positions.size(), (chunk + 1) * SOLVE_CHUNK);
+                for (auto i = chunk * SOLVE_CHUNK; i < last; ++i) {
+                    const auto outcome = previous ? solvePosition(positions[i], childHash, previous->values)
+                                                  : TablebaseOutcome::DRAW;
+                    const auto index = hash(keys[i]);
+                    std::atomic_ref(layer.values[index / 32])
+                        .fetch_or(static_cast<uint64_t>(outcome) << (index % 32 * 2), std::memory_order_relaxed);
+                    ++chunkCounts[static_cast<std::size_t>(outcome)];
+                }
+                for (std::size_t outcome = 0; outcome < counts.size(); ++outcome) {
+                    counts[outcome].fetch_add(chunkCounts[outcome], std::memory_order_relaxed);
+                }
+            });
+            return {counts[0].load(), counts[1].load(), counts[2].load()};
+        }
+
+        [[nodiscard]] TablebaseOutcome solvePosition(const Position& position, const PerfectHash& childHash,
+                                                     const std::vector<uint64_t>& childValues) const noexcept {
+            const auto pieces = static_cast<uint32_t>(std::popcount(position.occupied));
+            const uint8_t player = pieces % 2 == 0 ? 1 : 2;
+            const auto current = player == 1 ? position.player1 : position.occupied ^ position.player1;
+
+            for (uint16_t col = 0; col < width; ++col) {
+                const auto move = (position.occupied + columnBottom(col)) & columnMask(col);
+                if (move && hasFour(current | move)) return TablebaseOutcome::WIN;
+            }
+
+            const auto [hash, mirror] = hashes(position);
+            const auto side = zobrist::sideKey(player == 1 ? 2 : 1);
+            auto outcome = TablebaseOutcome::LOSS;
+            for (uint16_t col = 0; col < width; ++col) {
+                const auto row = static_cast<uint32_t>(std::popcount(position.occupied & columnMask(col)));
+                if (row == height) continue;
+                const auto childHashKey = hash ^ zobrist::pieceKey(col * height + row, player);
+                const auto childMirror = mirror ^ zobrist::pieceKey((width - 1 - col) * height + row, player);
+                const auto child = Tablebase::Layer::outcomeAt(childValues, childHash(std::min(childHashKey, childMirror) ^ side));
+                if (child == TablebaseOutcome::LOSS) return TablebaseOutcome::WIN;
+                if (child == TablebaseOutcome::DRAW) outcome = TablebaseOutcome::DRAW;
+            }
+            return outcome;
+        }
+    };
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            const auto value = [&] {
+                if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + arg);
+                return std::stoi(argv[++i]);
+            };
+            if (arg == "--empty") options.empty = static_cast<uint16_t>(value());
+            else if (arg == "--width") options.width = static_cast<uint16_t>(value());
+            else if (arg == "--height") options.height = static_cast<uint16_t>(value());
+            else if (options.output.empty()) options.output = arg;
+            else throw std::invalid_argument("Unknown argument " + arg);
+        }
+        if (options.output.empty()) {
+            throw std::invalid_argument("Missing output path");
+        }
+        if (options.width < 1 || options.height < 1 || !Board::fitsBitboard(options.width, options.height)) {
+            throw std::invalid_argument("The board must fit a 64-bit bitboard: (height + 1) * width <= 64");
+        }
+        options.empty = std::min<uint16_t>(options.empty, static_cast<uint16_t>(options.width * options.height));
+
+        const auto start = std::chrono::steady_clock::now();
+        Generator generator(options.width, options.height);
+        const auto layers = generator.solve(options.empty);
+        const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+        if (const auto written = Tablebase::write(options.output, options.width, options.height, layers); !written) {
+            std::println("{}", written.error());
+            return 1;
+        }
+        uint64_t positions = 0;
+        for (const auto& layer : layers) positions += layer.positionCount;
+        std::println("Wrote {} positions to {} in {:.2f} seconds", positions, options.output, duration.count());
+        return 0;
+    } catch (const std::exception& e) {
+        std::println("{}", e.what());
+        std::println("Usage: ConnectFourTablebase <output> [--empty N] [--width W] [--height H]");
+        return 1;
+    }
+}
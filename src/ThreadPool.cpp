@@ -0,0 +1,128 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace {
+    // Pool and worker index of the calling thread, so submissions from a worker go to its own deque
+    thread_local const ThreadPool* currentPool = nullptr;
+    thread_local unsigned currentWorker = 0;
+}
+
+ThreadPool::ThreadPool(const unsigned threads) {
+    ensureWorkers(std::max(1u, threads));
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        const std::scoped_lock lock(sleepMutex);
+        stopping.store(true, std::memory_order_relaxed);
+    }
+    wake.notify_all();
+    for (unsigned i = 0; i < size(); ++i) {
+        workers[i]->thread.join();
+    }
+}
+
+ThreadPool& ThreadPool::global() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::ensureWorkers(const unsigned count) {
+    const std::scoped_lock lock(growMutex);
+    if (count > MAX_WORKERS) {
+        throw std::invalid_argument("Too many worker threads");
+    }
+    for (auto index = size(); index < count; ++index) {
+        workers[index] = std::make_unique<Worker>();
+        workerCount.store(index + 1, std::memory_order_release);
+        workers[index]->thread = std::thread(&ThreadPool::workerLoop, this, index);
+    }
+}
+
+void ThreadPool::submit(Task task, const void* group) {
+    const auto count = size();
+    const auto target = currentPool == this ? currentWorker : nextWorker.fetch_add(1, std::memory_order_relaxed) % count;
+
+    // Counted before it is queued so a thief can never take the count below zero
+    queuedTasks.fetch_add(1, std::memory_order_release);
+    {
+        const std::scoped_lock lock(workers[target]->mutex);
+        workers[target]->tasks.push_back({std::move(task), group});
+    }
+
+    // Taking the sleep mutex orders the push with a worker checking for tasks before sleeping
+    { const std::scoped_lock lock(sleepMutex); }
+    wake.notify_one();
+}
+
+bool ThreadPool::takeTask(const unsigned self, Task& task, const void* group) {
+    const auto count = size();
+    const auto matches = [group](const QueuedTask& queued) {
+        return group == nullptr || queued.group == group;
+    };
+    const auto take = [&](std::deque<QueuedTask>& tasks, const std::deque<QueuedTask>::iterator it) {
+        task = std::move(it->task);
+        tasks.erase(it);
+        queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+    };
+
+    // Own deque first, newest task
+    if (self < count) {
+        auto& worker = *workers[self];
+        const std::scoped_lock lock(worker.mutex);
+        const auto newest = std::find_if(worker.tasks.rbegin(), worker.tasks.rend(), matches);
+        if (newest != worker.tasks.rend()) {
+            take(worker.tasks, std::next(newest).base());
+            return true;
+        }
+    }
+
+    // Then steal the oldest task of another worker, starting after self to spread the thieves
+    for (unsigned offset = 1; offset <= count; ++offset) {
+        auto& victim = *workers[(self + offset) % count];
+        const std::scoped_lock lock(victim.mutex);
+        if (const auto it = std::ranges::find_if(victim.tasks, matches); it != victim.tasks.end()) {
+            take(victim.tasks, it);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::runPendingTask(const void* group) {
+    if (queuedTasks.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    Task task;
+    // Threads outside the pool have no deque of their own and only steal
+    if (!takeTask(currentPool == this ? currentWorker : MAX_WORKERS, task, group)) {
+        return false;
+    }
+    task();
+    return true;
+}
+
+void ThreadPool::workerLoop(const unsigned index) {
+    currentPool = this;
+    currentWorker = index;
+
+    Task task;
+    while (true) {
+        if (takeTask(index, task, nullptr)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock lock(sleepMutex);
+        wake.wait(lock, [this] {
+            return stopping.load(std::memory_order_relaxed) || queuedTasks.load(std::memory_order_acquire) != 0;
+        });
+        if (stopping.load(std::memory_order_relaxed)) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,161 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+// Persistent work-stealing thread pool shared by the searches, the simulators and the offline tools.
+// Every worker owns a deque: it pushes and pops its own tasks at the back (newest first, so nested
+// work stays cache-hot) and idle workers steal from the front of the others (oldest, usually the
+// largest pieces of work). Tasks submitted from outside the pool are dealt round-robin. Workers
+// sleep on a condition variable while no task is queued and live as long as the pool. A task may be
+// tagged with the group that submitted it, so a thread waiting on that group only runs its own work.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(unsigned threads = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Process-wide pool, one worker per hardware thread to start with
+    [[nodiscard]] static ThreadPool& global();
+
+    [[nodiscard]] unsigned size() const noexcept {
+        return workerCount.load(std::memory_order_acquire);
+    }
+
+    // Starts workers until there are at least count; a search asking for more threads than cores
+    // still gets them all running at once
+    void ensureWorkers(unsigned count);
+
+    void submit(Task task, const void* group = nullptr);
+
+    // Runs one queued task submitted for group on the calling thread, stealing if needed; false when
+    // none is queued
+    bool runPendingTask(const void* group);
+
+private:
+    static constexpr unsigned MAX_WORKERS = 256;
+
+    struct QueuedTask {
+        Task task;
+        const void* group;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<QueuedTask> tasks;
+        std::thread thread;
+    };
+
+    // Slots are filled before workerCount is raised and never cleared while the pool lives, so
+    // thieves can index them without holding growMutex
+    std::array<std::unique_ptr<Worker>, MAX_WORKERS> workers;
+    std::atomic<unsigned> workerCount{0};
+    std::mutex growMutex;
+
+    std::atomic<unsigned> queuedTasks{0};
+    std::atomic<unsigned> nextWorker{0};
+    std::atomic<bool> stopping{false};
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+
+    // Any task when group is nullptr, otherwise only one of that group
+    [[nodiscard]] bool takeTask(unsigned self, Task& task, const void* group);
+    void workerLoop(unsigned index);
+};
+
+// Fork-join scope on a pool: run() queues tasks and wait() returns once all of them finished. The
+// waiting thread runs the group's own queued tasks in the meantime, so nested groups never deadlock,
+// and sleeps once the rest are running elsewhere. It never picks up another group's task, which may
+// be long or block on input. The first exception thrown by a task is rethrown by wait().
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool = ThreadPool::global()) noexcept
+        : pool(pool)
+    {}
+
+    ~TaskGroup() {
+        waitForTasks();
+    }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    template<typename Function>
+    void run(Function&& function) {
+        {
+            const std::scoped_lock lock(mutex);
+            ++pending;
+        }
+        pool.submit([this, function = std::forward<Function>(function)]() mutable {
+            std::exception_ptr thrown;
+            try {
+                function();
+            } catch (...) {
+                thrown = std::current_exception();
+            }
+            // Notified under the lock: the waiter cannot return and destroy the group before it is done
+            const std::scoped_lock lock(mutex);
+            if (thrown && !error) error = thrown;
+            if (--pending == 0) finished.notify_all();
+        }, this);
+    }
+
+    void wait() {
+        waitForTasks();
+        if (error) {
+            std::rethrow_exception(std::exchange(error, nullptr));
+        }
+    }
+
+private:
+    ThreadPool& pool;
+    std::mutex mutex;
+    std::condition_variable finished;
+    unsigned pending{0};
+    std::exception_ptr error;
+
+    void waitForTasks() noexcept {
+        std::unique_lock lock(mutex);
+        while (pending != 0) {
+            lock.unlock();
+            const bool ran = pool.runPendingTask(this);
+            lock.lock();
+            // Nothing of this group is queued, so every unfinished task is running on another thread
+            if (!ran && pending != 0) {
+                finished.wait(lock);
+            }
+        }
+    }
+};
+
+// Calls function(index) for every index in [begin, end) on the pool plus the calling thread.
+// Indices are handed out one at a time, so uneven work still balances across all threads.
+template<typename Function>
+void parallelFor(const std::size_t begin, const std::size_t end, Function&& function,
+                 ThreadPool& pool = ThreadPool::global()) {
+    std::atomic<std::size_t> next{begin};
+    const auto drain = [&] {
+        for (auto index = next++; index < end; index = next++) {
+            function(index);
+        }
+    };
+
+    TaskGroup group(pool);
+    for (unsigned i = 0; i < pool.size() && begin + i + 1 < end; ++i) {
+        group.run(drain);
+    }
+    drain();
+    group.wait();
+}
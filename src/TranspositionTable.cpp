@@ -0,0 +1,108 @@
+#include "TranspositionTable.hpp"
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <new>
+#include <stdexcept>
+
+TranspositionTable::TranspositionTable(const std::size_t megabytes) {
+    resize(megabytes);
+}
+
+void TranspositionTable::resize(const std::size_t megabytes) {
+    const auto requested = std::max<std::size_t>(megabytes * 1024 * 1024 / sizeof(Bucket), 1);
+    const auto count = std::bit_floor(requested);
+
+    try {
+        buckets = std::make_unique<Bucket[]>(count);
+    } catch (const std::bad_alloc&) {
+        throw std::runtime_error("Failed to allocate transposition table memory");
+    }
+    bucketCount = count;
+    bucketMask = count - 1;
+    generation.store(0, std::memory_order_relaxed);
+}
+
+void TranspositionTable::clear() noexcept {
+    for (std::size_t i = 0; i < bucketCount; ++i) {
+        for (auto& slot : buckets[i].slots) {
+            slot.keyXorData.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation.store(0, std::memory_order_relaxed);
+}
+
+void TranspositionTable::newSearch() noexcept {
+    generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t TranspositionTable::pack(const int score, const int depth, const Bound bound, const uint16_t bestMove,
+                                  const uint8_t generation) noexcept {
+    const uint64_t move = bestMove == NO_MOVE ? PACKED_NO_MOVE : std::min<uint64_t>(bestMove, PACKED_NO_MOVE - 1);
+    return static_cast<uint32_t>(score)
+         | move << 32
+         | static_cast<uint64_t>(std::clamp(depth, 0, 0xFF)) << 42
+         | static_cast<uint64_t>(bound) << 50
+         | static_cast<uint64_t>(generation) << 52;
+}
+
+TranspositionTable::Entry TranspositionTable::unpack(const uint64_t data) noexcept {
+    const auto move = (data >> 32) & PACKED_NO_MOVE;
+    return Entry{
+        static_cast<int32_t>(static_cast<uint32_t>(data)),
+        static_cast<int16_t>(depthOf(data)),
+        boundOf(data),
+        move == PACKED_NO_MOVE ? NO_MOVE : static_cast<uint16_t>(move)
+    };
+}
+
+std::optional<TranspositionTable::Entry> TranspositionTable::probe(const uint64_t key) const noexcept {
+    for (const auto& slot : buckets[key & bucketMask].slots) {
+        const auto data = slot.data.load(std::memory_order_relaxed);
+        const auto keyXorData = slot.keyXorData.load(std::memory_order_relaxed);
+        if ((keyXorData ^ data) == key && boundOf(data) != Bound::NONE) {
+            return unpack(data);
+        }
+    }
+    return std::nullopt;
+}
+
+void TranspositionTable::store(const uint64_t key, const int score, const int depth, const Bound bound,
+                               const uint16_t bestMove) noexcept {
+    auto& slots = buckets[key & bucketMask].slots;
+    const auto currentGeneration = generation.load(std::memory_order_relaxed);
+
+    // Prefer the slot already holding this position, then the least valuable one
+    Slot* replace = &slots[0];
+    uint64_t replaceData = 0;
+    bool sameKey = false;
+    int replaceValue = std::numeric_limits<int>::max();
+    for (auto& slot : slots) {
+        const auto data = slot.data.load(std::memory_order_relaxed);
+        const auto keyXorData = slot.keyXorData.load(std::memory_order_relaxed);
+        if (boundOf(data) == Bound::NONE || (keyXorData ^ data) == key) {
+            replace = &slot;
+            replaceData = data;
+            sameKey = boundOf(data) != Bound::NONE;
+            break;
+        }
+        const int age = static_cast<uint8_t>(currentGeneration - generationOf(data));
+        if (const int value = depthOf(data) - 4 * age; value < replaceValue) {
+            replaceValue = value;
+            replace = &slot;
+            replaceData = data;
+        }
+    }
+
+    // Keep a deeper result for the same position from the current search unless the new one is exact
+    if (sameKey && generationOf(replaceData) == currentGeneration && depthOf(replaceData) > depth &&
+        bound != Bound::EXACT) {
+        return;
+    }
+
+    const auto keptMove = bestMove == NO_MOVE && sameKey ? unpack(replaceData).bestMove : bestMove;
+    const auto data = pack(score, depth, bound, keptMove, currentGeneration);
+    replace->keyXorData.store(key ^ data, std::memory_order_relaxed);
+    replace->data.store(data, std::memory_order_relaxed);
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+// Fixed-size, preallocated transposition table keyed by 64-bit Zobrist keys, safe to share
+// between search threads without locks.
+// Entries live in cache-line sized buckets selected by the low key bits. Each entry is two
+// relaxed atomic words, (key ^ data) and data: a torn write from a concurrent store fails the
+// XOR verification on probe and reads as a miss. When a bucket is full the entry with the
+// lowest depth, penalized by how many searches ago it was written, is replaced.
+class TranspositionTable {
+public:
+    enum class Bound : uint8_t { NONE, EXACT, LOWER, UPPER };
+
+    struct Entry {
+        int32_t score;
+        int16_t depth;
+        Bound bound;
+        uint16_t bestMove;
+    };
+
+    static constexpr uint16_t NO_MOVE = 0xFFFF;
+    static constexpr std::size_t DEFAULT_SIZE_MB = 64;
+
+    explicit TranspositionTable(std::size_t megabytes = DEFAULT_SIZE_MB);
+
+    // Reallocates the table to the largest power-of-two bucket count fitting the budget, dropping all entries.
+    // Not thread-safe: no search may be running.
+    void resize(std::size_t megabytes);
+    void clear() noexcept;
+
+    // Starts a new search generation so entries from older searches are replaced first
+    void newSearch() noexcept;
+
+    [[nodiscard]] std::optional<Entry> probe(uint64_t key) const noexcept;
+    void store(uint64_t key, int score, int depth, Bound bound, uint16_t bestMove) noexcept;
+
+    [[nodiscard]] std::size_t sizeInBytes() const noexcept {
+        return bucketCount * sizeof(Bucket);
+    }
+
+private:
+    // data layout: score (32) | best move (10) | depth (8) | bound (2) | generation (8)
+    struct Slot {
+        std::atomic<uint64_t> keyXorData{0};
+        std::atomic<uint64_t> data{0};
+    };
+    static_assert(sizeof(Slot) == 16);
+
+    static constexpr std::size_t SLOTS_PER_BUCKET = 4;
+    static constexpr uint64_t PACKED_NO_MOVE = 0x3FF;
+
+    struct alignas(64) Bucket {
+        std::array<Slot, SLOTS_PER_BUCKET> slots;
+    };
+
+    std::unique_ptr<Bucket[]> buckets;
+    std::size_t bucketCount{0};
+    uint64_t bucketMask{0};
+    std::atomic<uint8_t> generation{0};
+
+    [[nodiscard]] static uint64_t pack(int score, int depth, Bound bound, uint16_t bestMove, uint8_t generation) noexcept;
+    [[nodiscard]] static Entry unpack(uint64_t data) noexcept;
+
+    [[nodiscard]] static Bound boundOf(const uint64_t data) noexcept {
+        return static_cast<Bound>((data >> 50) & 0x3);
+    }
+    [[nodiscard]] static int depthOf(const uint64_t data) noexcept {
+        return static_cast<int>((data >> 42) & 0xFF);
+    }
+    [[nodiscard]] static uint8_t generationOf(const uint64_t data) noexcept {
+        return static_cast<uint8_t>(data >> 52);
+    }
+};
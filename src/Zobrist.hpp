@@ -0,0 +1,27 @@
+#ifndef ZOBRIST_HPP
+#define ZOBRIST_HPP
+
+#include <cstdint>
+
+// Zobrist keys are derived on the fly from a splitmix64 mix of (cell, player), so boards of any size
+// share the same key space without a table that grows with width * height.
+namespace zobrist {
+    [[nodiscard]] constexpr uint64_t mix(uint64_t x) noexcept {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    // Key for a piece of player (1-based) at cellIndex = col * height + rowFromBottom
+    [[nodiscard]] constexpr uint64_t pieceKey(const uint32_t cellIndex, const uint8_t player) noexcept {
+        return mix((static_cast<uint64_t>(cellIndex) << 3) | player);
+    }
+
+    // Key for the side to move, XORed into the position key by the search
+    [[nodiscard]] constexpr uint64_t sideKey(const uint8_t player) noexcept {
+        return mix(~static_cast<uint64_t>(player));
+    }
+}
+
+#endif // ZOBRIST_HPP
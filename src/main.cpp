@@ -6,7 +6,6 @@
 
 #include "AI.hpp"
 #include "Game.hpp"
-#include "Benchmark.hpp"
 #include "BoardPrinter.hpp"
 
 uint16_t getColFromInput() {
@@ -27,42 +26,44 @@ uint16_t getColFromInput() {
 }
 
 int main() {
-    constexpr bool run_benchmark = false;
+    Game game(7, 6, 2);
 
-    if (run_benchmark) {
-        runBenchmark();
-    } else {
-        Game game(7, 6, 2);
+    // The book is optional; without it every move is searched
+    if (loadOpeningBook("opening.book")) {
+        std::println("Loaded opening book");
+    }
 
-        std::optional<MoveResult> gameResult = std::nullopt;
+    std::optional<MoveResult> gameResult = std::nullopt;
 
-        while (!gameResult) {
-            if (game.currentPlayer == 1) {
-                const auto col = getColFromInput();
-                gameResult = game.place(col);
-            } else {
-                const auto col = getMove(game);
-                std::println("AI Play: Col: {}", col);
-                gameResult = game.place(col);
-            }
-            if (!gameResult) {
-                BoardPrinter::printBoard(game.board);
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
-            }
+    while (!gameResult) {
+        if (game.currentPlayer == 1) {
+            startPondering(game);  // Think on the human's time; getMove() picks up the results
+            const auto col = getColFromInput();
+            gameResult = game.place(col);
+        } else {
+            const auto col = getMove(game);
+            std::println("AI Play: Col: {}", col);
+            gameResult = game.place(col);
+        }
+        if (!gameResult) {
+            BoardPrinter::printBoard(game.board);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
         }
+    }
+
+    stopPondering();
 
-        // Print final result
-        if (gameResult) {
-            if (const auto& [move, result] = *gameResult; result.win) {
-                const auto [hasWon, winner, winningCells] = game.board.checkWinDetailed(move.first, move.second);
+    // Print final result
+    if (gameResult) {
+        if (const auto& [move, result] = *gameResult; result.win) {
+            const auto [hasWon, winner, winningCells] = game.board.checkWinDetailed(move.first, move.second);
 
-                BoardPrinter::printBoard(game.board, &winningCells);
-                std::println("Player {} won!", game.currentPlayer);
-                std::println("Winning move: {} {}", move.first, move.second);
-                std::println("Wincheck2: {} Winner: {}", hasWon, winner);
-            } else if (result.draw) {
-                std::println("Game ended in a draw!");
-            }
+            BoardPrinter::printBoard(game.board, winningCells);
+            std::println("Player {} won!", game.currentPlayer);
+            std::println("Winning move: {} {}", move.first, move.second);
+            std::println("Wincheck2: {} Winner: {}", hasWon, winner);
+        } else if (result.draw) {
+            std::println("Game ended in a draw!");
         }
     }
 
@@ -0,0 +1,86 @@
+// Checks that the search allocates nothing per node: global operator new is counted, and searches of
+// the same position to a shallow and to a deep depth must allocate exactly as often, however many more
+// nodes the deep one visits. Exits non-zero on failure, for ctest.
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <print>
+#include <string_view>
+
+#include "FixedGame.hpp"
+#include "Game.hpp"
+#include "Solver.hpp"
+
+namespace {
+    std::atomic<unsigned long long> allocations{0};
+}
+
+void* operator new(const std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    const auto align = static_cast<std::size_t>(alignment);
+    if (void* pointer = std::aligned_alloc(align, (size + align - 1) / align * align)) return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+namespace {
+    struct Count {
+        unsigned long long allocations;
+        unsigned long long nodes;
+    };
+
+    template<typename GameType>
+    Count countSearch(Solver<GameType>& solver, const GameType& game, const int depth) {
+        solver.newGame();
+        const auto before = allocations.load(std::memory_order_relaxed);
+        const auto result = solver.search(game, {.maxDepth = depth});
+        return {allocations.load(std::memory_order_relaxed) - before, result.nodes};
+    }
+
+    // One thread, so no helper is started; the table is allocated by the constructor
+    template<typename GameType>
+    bool check(const std::string_view name, const GameType& game) {
+        Solver<GameType> solver(16, 1);
+        (void)countSearch(solver, game, 2);  // Warm-up: lazily created statics such as the thread pool
+        const auto shallow = countSearch(solver, game, 2);
+        const auto deep = countSearch(solver, game, 12);
+        const bool passed = deep.allocations == shallow.allocations && deep.nodes > 100 * shallow.nodes;
+        std::println("{}: {} allocations at depth 2 ({} nodes), {} at depth 12 ({} nodes): {}", name,
+                     shallow.allocations, shallow.nodes, deep.allocations, deep.nodes, passed ? "ok" : "FAILED");
+        return passed;
+    }
+
+    template<typename GameType>
+    GameType opening(GameType game) {
+        for (const uint16_t col : {3, 3, 2, 4}) (void)game.place(col);
+        return game;
+    }
+}
+
+int main() {
+    bool passed = check("FixedGame<7, 6>", opening(FixedGame<7, 6>{}));
+    passed = check("Game 7x6", opening(Game(7, 6, 2))) && passed;
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}